@@ -1,7 +1,5 @@
 #pragma once
 
-#ifdef USE_ARDUINO
-
 #include "esphome/core/automation.h"
 #include "air_conditioner.h"
 
@@ -61,8 +59,41 @@ template<typename... Ts> class PowerToggleAction : public MideaActionBase<Ts...>
   void play(const Ts &...x) override { this->parent_->do_power_toggle(); }
 };
 
+/// Fires with the code ("E1", "P4", ...) of every fault that becomes active
+class ErrorTrigger : public Trigger<std::string> {
+ public:
+  explicit ErrorTrigger(AirConditioner *parent) {
+    parent->add_on_error_callback([this](const std::string &code) { this->trigger(code); });
+  }
+};
+
+/// Fires when a C4 snapshot raises the given CompressorEvent bit
+class CompressorEventTrigger : public Trigger<> {
+ public:
+  CompressorEventTrigger(AirConditioner *parent, uint8_t event) {
+    parent->add_on_compressor_event_callback([this, event](uint8_t events) {
+      if (events & event)
+        this->trigger();
+    });
+  }
+};
+
+/// Fires with the new mode when it was changed on the unit side
+class UnitModeChangeTrigger : public Trigger<ClimateMode> {
+ public:
+  explicit UnitModeChangeTrigger(AirConditioner *parent) {
+    parent->add_on_unit_mode_change_callback([this](ClimateMode mode) { this->trigger(mode); });
+  }
+};
+
+/// Fires with every decoded response; the frame is passed by reference and only valid during the automation
+class FrameTrigger : public Trigger<const ReceiveData &> {
+ public:
+  explicit FrameTrigger(AirConditioner *parent) {
+    parent->add_on_frame_callback([this](const ReceiveData &frame) { this->trigger(frame); });
+  }
+};
+
 }  // namespace xye
 }  // namespace midea
 }  // namespace esphome
-
-#endif  // USE_ARDUINO
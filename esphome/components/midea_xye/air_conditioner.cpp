@@ -1,7 +1,7 @@
-#ifdef USE_ARDUINO
-
 #include "air_conditioner.h"
 
+#include <ctime>
+
 #include "esphome/core/log.h"
 
 namespace esphome {
@@ -18,6 +18,11 @@ static void set_sensor(Sensor *sensor, float value) {
     sensor->publish_state(value);
 }
 
+static void set_binary_sensor(BinarySensor *sensor, bool value) {
+  if (sensor != nullptr && (!sensor->has_state() || sensor->state != value))
+    sensor->publish_state(value);
+}
+
 static void set_number(number::Number *number, float value) {
   if (number != nullptr && (!number->has_state() || number->state != value))
     number->publish_state(value);
@@ -33,6 +38,7 @@ template<typename T> void update_property(T &property, const T &value, bool &fla
 void AirConditioner::control(const ClimateCall &call) {
   if (call.get_mode().has_value()) {
     this->mode = call.get_mode().value();
+    this->mode_intent_.arm(this->mode);
     // Reset Follow-Me initialization flag when mode changes to ensure
     // proper initialization sequence is sent on next Follow-Me update
     followMeInit = false;
@@ -45,12 +51,87 @@ void AirConditioner::control(const ClimateCall &call) {
     this->swing_mode = call.get_swing_mode().value();
   if (call.get_preset().has_value())
     this->preset = call.get_preset().value();
+  // The unit only reports setpoint, swing and preset while running,
+  // so those can only be confirmed when the requested mode is an ON state.
+  if (this->mode != ClimateMode::CLIMATE_MODE_OFF) {
+    if (call.get_target_temperature().has_value())
+      this->target_temperature_intent_.arm(this->target_temperature);
+    if (call.get_swing_mode().has_value())
+      this->swing_intent_.arm(this->swing_mode != ClimateSwingMode::CLIMATE_SWING_OFF);
+    if (call.get_preset().has_value())
+      this->preset_intent_.arm(*this->preset);
+  }
+  // Publish optimistically so the frontend reflects the change right away,
+  // even if the SET itself is held back by the settle window.
   this->publish_state();
 
+  this->queue_set_();
+}
+
+void AirConditioner::queue_set_() {
+  if (this->control_settle_time_ == 0) {
+    this->queue_command_(STATE_SEND_SET);
+    return;
+  }
+  // Bursts of calls (e.g. dragging the setpoint slider) are merged into the
+  // climate state above; only the first call of a burst arms the timer, so
+  // the bus sees at most one SET per settle window carrying the latest state.
+  if (this->control_settle_pending_)
+    return;
+  this->control_settle_pending_ = true;
+  this->set_timeout("control-settle", this->control_settle_time_, [this]() {
+    this->control_settle_pending_ = false;
+    this->queue_command_(STATE_SEND_SET);
+  });
+}
+
+void AirConditioner::mark_intents_sent_() {
+  const uint32_t now = millis();
+  this->mode_intent_.mark_sent(now);
+  this->target_temperature_intent_.mark_sent(now);
+  this->swing_intent_.mark_sent(now);
+  this->preset_intent_.mark_sent(now);
+}
+
+template<typename T>
+bool AirConditioner::reconcile_intent_(PendingIntent<T> &intent, const T &current, const T &reported,
+                                       const char *field) {
+  switch (intent.reconcile(reported, this->intent_confirm_cycles_, this->intent_max_retries_)) {
+    case IntentResult::PENDING:
+      return false;
+    case IntentResult::CONFIRMED:
+      if (intent.sent_at != 0) {
+        const uint32_t latency = millis() - intent.sent_at;
+        ESP_LOGD(Constants::TAG, "Unit confirmed %s after %ums", field, latency);
+        set_sensor(this->confirmation_latency_sensor_, latency);
+      }
+      return true;
+    case IntentResult::RESEND:
+      ESP_LOGW(Constants::TAG, "Unit has not confirmed %s, re-sending SET (retry %u)", field, intent.retries);
+      this->queue_command_(STATE_SEND_SET);
+      return false;
+    case IntentResult::ROLLBACK:
+      ESP_LOGW(Constants::TAG, "Unit did not accept %s, rolling back to reported state", field);
+      return true;
+    case IntentResult::NONE:
+    default:
+      // Nothing requested from our side, so a change here was made on the unit
+      // itself (wired controller, IR remote, protection logic).
+      if (ForceReadNextCycle == 0 && !intent_matches(current, reported))
+        ESP_LOGI(Constants::TAG, "%s changed on the unit side", field);
+      return true;
+  }
+}
+
+void AirConditioner::queue_command_(uint8_t state) {
+  // Never let a Follow-Me update displace a pending SET. The SET is followed
+  // by a Follow-Me frame anyway, which then carries the latest temperature.
   if (controlState != STATE_WAIT_DATA) {
-    controlState = STATE_SEND_SET;
+    if (controlState != STATE_SEND_SET)
+      controlState = state;
   } else {
-    queuedCommand = STATE_SEND_SET;
+    if (queuedCommand != STATE_SEND_SET)
+      queuedCommand = state;
   }
 }
 
@@ -63,6 +144,156 @@ void AirConditioner::setup() {
 
   // Start up in Auto fan mode (since unit doesn't report it correctly)
   this->fan_mode = ClimateFanMode::CLIMATE_FAN_AUTO;
+
+  // 16 bytes at 4800 8N1 take 34 ms
+  this->tx_time_ = this->frame_time_ms_(TX_LEN);
+
+#ifdef USE_ESP32
+  if (this->use_bus_task_)
+    this->start_bus_task_();
+#endif
+
+  if (this->power_sensor_ != nullptr || this->energy_sensor_ != nullptr) {
+    this->energy_pref_ = global_preferences->make_preference<EnergyRestoreState>(
+        this->get_object_id_hash() ^ fnv1_hash("midea_xye_energy"), true);
+    EnergyRestoreState state;
+    if (this->energy_pref_.load(&state)) {
+      this->energy_.set_energy_kwh(state.energy_kwh);
+      this->energy_.set_coefficients(state.coefficients);
+      ESP_LOGI(Constants::TAG, "Restored energy total %.3f kWh", state.energy_kwh);
+    }
+  }
+
+  // Written only after a new fault appears, coalesced like the energy total
+  if (this->fault_persist_) {
+    this->fault_pref_ = global_preferences->make_preference<FaultHistory>(
+        this->get_object_id_hash() ^ fnv1_hash("midea_xye_faults"), true);
+    FaultHistory history;
+    if (this->fault_pref_.load(&history))
+      this->faults_.restore(history);
+  }
+
+  this->compressor_persist_ = this->compressor_run_time_sensor_ != nullptr ||
+                              this->compressor_starts_sensor_ != nullptr || this->defrost_count_sensor_ != nullptr ||
+                              this->short_cycles_sensor_ != nullptr;
+  if (this->compressor_persist_) {
+    this->compressor_pref_ = global_preferences->make_preference<CompressorCounters>(
+        this->get_object_id_hash() ^ fnv1_hash("midea_xye_compressor"), true);
+    CompressorCounters counters;
+    if (this->compressor_pref_.load(&counters)) {
+      this->compressor_.restore(counters);
+      ESP_LOGI(Constants::TAG, "Restored compressor counters: %u s run, %u starts", counters.run_seconds,
+               counters.starts);
+    }
+  }
+}
+
+void AirConditioner::update_faults_(uint16_t errors, uint16_t protections) {
+  const uint32_t before = this->faults_.active();
+  // Wall-clock stamps only once something (SNTP, time component) has set the clock
+  const time_t epoch = ::time(nullptr);
+  const uint32_t appeared =
+      this->faults_.update(errors, protections, epoch > 1577836800 ? static_cast<uint32_t>(epoch) : 0, millis() / 1000);
+  const uint32_t after = this->faults_.active();
+
+  if (this->error_codes_text_sensor_ != nullptr &&
+      (before != after || !this->error_codes_text_sensor_->has_state())) {
+    char buffer[FaultDecoder::BITS * 3 + 1];
+    this->faults_.format_active(buffer, sizeof(buffer));
+    this->error_codes_text_sensor_->publish_state(buffer);
+  }
+  if (before == after)
+    return;
+
+  const uint32_t cleared = before & ~after;
+  for (uint8_t i = 0; i < FaultDecoder::BITS; i++) {
+    const FaultCode &fault = FaultDecoder::code(i);
+    if (cleared & (1UL << i))
+      ESP_LOGI(Constants::TAG, "Fault cleared: %s (%s)", fault.code, fault.description);
+    if (appeared & (1UL << i)) {
+      ESP_LOGW(Constants::TAG, "Fault: %s (%s)", fault.code, fault.description);
+      this->error_callback_.call(fault.code);
+    }
+  }
+  this->fault_dirty_ |= appeared != 0;
+}
+
+void AirConditioner::save_faults_() {
+  // A flapping protection bit must not turn into a flash write per flap
+  constexpr uint32_t FAULT_SAVE_INTERVAL_MS = 15 * 60 * 1000;
+  const uint32_t now = millis();
+  if (!this->fault_persist_ || !this->fault_dirty_ || now - this->fault_saved_at_ < FAULT_SAVE_INTERVAL_MS)
+    return;
+  this->fault_pref_.save(&this->faults_.history());
+  this->fault_dirty_ = false;
+  this->fault_saved_at_ = now;
+}
+
+void AirConditioner::update_compressor_() {
+  const uint8_t events = this->compressor_.update(this->compressor_sample_, millis());
+  const auto &counters = this->compressor_.counters();
+  if (events & COMPRESSOR_EVENT_SHORT_CYCLE)
+    ESP_LOGW(Constants::TAG, "Compressor short cycle: ran %u s", this->compressor_.cycle_ms(0) / 1000);
+  if (events & COMPRESSOR_EVENT_DEFROST_START)
+    ESP_LOGI(Constants::TAG, "Defrost started");
+  if (events != COMPRESSOR_EVENT_NONE)
+    this->compressor_event_callback_.call(events);
+
+  set_sensor(this->compressor_run_time_sensor_, std::round(counters.run_seconds / 36.0f) / 100.0f);
+  set_sensor(this->compressor_starts_sensor_, counters.starts);
+  set_sensor(this->defrost_count_sensor_, counters.defrosts);
+  set_sensor(this->short_cycles_sensor_, counters.short_cycles);
+  if (events & COMPRESSOR_EVENT_STOP) {
+    set_sensor(this->last_cycle_duration_sensor_, this->compressor_.cycle_ms(0) / 60000.0f);
+    set_sensor(this->average_cycle_duration_sensor_, this->compressor_.average_cycle_ms() / 60000.0f);
+  }
+
+  if (!this->compressor_persist_)
+    return;
+  // Run time changes on every snapshot; coalesce writes to protect the flash
+  constexpr uint32_t COMPRESSOR_SAVE_INTERVAL_MS = 15 * 60 * 1000;
+  this->compressor_dirty_ |= this->compressor_.running() || events != COMPRESSOR_EVENT_NONE;
+  const uint32_t now = millis();
+  if (this->compressor_dirty_ && now - this->compressor_saved_at_ >= COMPRESSOR_SAVE_INTERVAL_MS) {
+    this->compressor_pref_.save(&counters);
+    this->compressor_dirty_ = false;
+    this->compressor_saved_at_ = now;
+  }
+}
+
+void AirConditioner::set_power_reference_sensor(Sensor *sensor) {
+  // Every reading from a real power meter refines the model at the current operating point
+  sensor->add_on_state_callback([this](float watts) {
+    this->energy_.calibrate(this->power_inputs_, watts);
+    this->energy_dirty_ = true;
+  });
+}
+
+void AirConditioner::update_energy_() {
+  if (this->power_sensor_ == nullptr && this->energy_sensor_ == nullptr)
+    return;
+  const float watts = this->energy_.estimate(this->power_inputs_);
+  this->energy_.integrate(watts, millis());
+  this->energy_dirty_ = true;
+  set_sensor(this->power_sensor_, std::round(watts));
+  // 1 Wh resolution keeps the energy sensor from publishing on every frame
+  set_sensor(this->energy_sensor_, std::round(this->energy_.energy_kwh() * 1000.0) / 1000.0);
+  this->save_energy_();
+}
+
+void AirConditioner::save_energy_() {
+  // Coalesced: at most one write per interval, and only when something changed
+  constexpr uint32_t ENERGY_SAVE_INTERVAL_MS = 15 * 60 * 1000;
+  const uint32_t now = millis();
+  if (!this->energy_dirty_ || now - this->energy_saved_at_ < ENERGY_SAVE_INTERVAL_MS)
+    return;
+  EnergyRestoreState state;
+  state.energy_kwh = this->energy_.energy_kwh();
+  for (uint8_t i = 0; i < EnergyEstimator::FEATURES; i++)
+    state.coefficients[i] = this->energy_.coefficients()[i];
+  this->energy_pref_.save(&state);
+  this->energy_dirty_ = false;
+  this->energy_saved_at_ = now;
 }
 
 void AirConditioner::set_follow_me_sensor(Sensor *sensor) {
@@ -78,12 +309,9 @@ void AirConditioner::setPowerState(bool state) {
     this->mode = this->last_on_mode_;
   else
     this->mode = ClimateMode::CLIMATE_MODE_OFF;
+  this->mode_intent_.arm(this->mode);
 
-  if (controlState != STATE_WAIT_DATA) {
-    controlState = STATE_SEND_SET;
-  } else {
-    queuedCommand = STATE_SEND_SET;
-  }
+  this->queue_set_();
 }
 
 void AirConditioner::prepareTXData(uint8_t command) {
@@ -161,6 +389,13 @@ void AirConditioner::setACParams() {
     float tgt_temp = ((9.0 / 5.0) * this->target_temperature + 32.0);
 
     TXData[8] = (int) tgt_temp + 0x87;  // Offset from actual to engineering value
+  } else if (this->uses_half_degree_() || this->half_degree_probe_due_()) {
+    // Encoded form carries the half degree. Its range (0x4A-0x64 for 17-30 °C)
+    // never overlaps the raw whole-degree form, so the unit can tell them apart.
+    const float half_degrees = roundf(this->target_temperature * 2.0f) / 2.0f;
+    TXData[8] = Temperature::from_celsius(half_degrees).value;
+    if (!this->uses_half_degree_())
+      this->half_degree_probe_ = half_degrees;
   } else {
     TXData[8] = (int) this->target_temperature;
   }
@@ -180,56 +415,173 @@ void AirConditioner::setACParams() {
 }
 
 void AirConditioner::sendRecv(uint8_t cmdSent) {
-  // TODO: Reimplement flow control for manual RS485 flow control chips
-  // digitalWrite(ComControlPin, RS485_TX_PIN_VALUE);
   // Log outgoing message at debug level
   tx_data.print_debug(Constants::TAG, TX_MESSAGE_LENGTH, ESPHOME_LOG_LEVEL_DEBUG);
-  this->uart_->write_array(TXData, TX_LEN);
-  this->uart_->flush();
   controlState = STATE_WAIT_DATA;
-  // Delay the remaining for 100 ms to allow response from the AC unit.
-  this->set_timeout("read-result", 100, [this, cmdSent]() {
-    // digitalWrite(ComControlPin, RS485_RX_PIN_VALUE);
-
-    uint8_t i = 0;
-    while (this->uart_->available()) {
-      if (i < RX_LEN)
-        this->uart_->read_byte(&RXData[i]);
-      i++;
+  this->rx_command_ = cmdSent;
+#ifdef USE_ESP32
+  if (this->bus_task_handle_ != nullptr) {
+    // The bus task owns the UART; the reply comes back through bus_results_.
+    // At most one transaction is in flight, so the queue cannot be full.
+    this->bus_requests_.push(BusRequest{cmdSent, this->tx_data});
+    xTaskNotifyGive(this->bus_task_handle_);
+    return;
+  }
+#endif
+  // TODO: Reimplement flow control for manual RS485 flow control chips
+  // digitalWrite(ComControlPin, RS485_TX_PIN_VALUE);
+  this->drain_rx_();
+  // No flush(): the frame fits the UART FIFO and goes out on its own, so instead of
+  // blocking for the whole transmission loop() waits out tx_time_ before listening.
+  this->uart_->write_array(TXData, TX_LEN);
+  this->rx_length_ = 0;
+  this->rx_started_at_ = millis();
+}
+
+void AirConditioner::loop() {
+#ifdef USE_ESP32
+  if (this->bus_task_handle_ != nullptr) {
+    BusResult result;
+    while (this->bus_results_.pop(result)) {
+      this->rx_data = result.frame;
+      this->handle_response_(result.command, result.length);
     }
-    if (i == RX_LEN) {
-      // Log incoming message at debug level
-      rx_data.print_debug(i, Constants::TAG, ESPHOME_LOG_LEVEL_DEBUG);
-      // Don't parse responses to SET or FOLLOW_ME commands to avoid
-      // overwriting the mode we just set. The AC state will be updated
-      // on subsequent QUERY cycles.
-      if (cmdSent != CLIENT_COMMAND_SET && cmdSent != CLIENT_COMMAND_FOLLOWME) {
-        ParseResponse(cmdSent);
-      }
-      if (queuedCommand != 0) {
-        controlState = queuedCommand;
-        queuedCommand = 0;
-      } else {
-        switch (cmdSent) {
-          case CLIENT_COMMAND_QUERY:
-            controlState = STATE_SEND_QUERY_EXTENDED;
-            break;
-          case CLIENT_COMMAND_SET:
+    return;
+  }
+#endif
+  if (controlState != STATE_WAIT_DATA)
+    return;
+  // The reply is handled as soon as the frame is complete; response_timeout,
+  // counted from the end of our transmission, only bounds the wait.
+  const uint32_t elapsed = millis() - this->rx_started_at_;
+  if (elapsed < this->tx_time_)
+    return;
+  this->high_freq_.start();
+  if (!this->read_reply_(RXData, this->rx_length_) && elapsed < this->tx_time_ + this->response_timeout)
+    return;
+  this->high_freq_.stop();
+  this->handle_response_(this->rx_command_, this->rx_length_);
+}
+
+void AirConditioner::drain_rx_() {
+  // Anything left in the RX buffer (late reply, line noise) would misalign the next frame
+  uint8_t stale;
+  while (this->uart_->available())
+    this->uart_->read_byte(&stale);
+}
+
+uint32_t AirConditioner::frame_time_ms_(uint8_t bytes) const {
+  // Start bit, data bits, optional parity bit and stop bits per byte, rounded up
+  const uint32_t bits_per_byte = 1 + this->uart_->get_data_bits() +
+                                 (this->uart_->get_parity() != uart::UART_CONFIG_PARITY_NONE ? 1 : 0) +
+                                 this->uart_->get_stop_bits();
+  const uint32_t baud = this->uart_->get_baud_rate();
+  if (baud == 0)
+    return 0;
+  return (bytes * bits_per_byte * 1000 + baud - 1) / baud;
+}
+
+bool AirConditioner::read_reply_(uint8_t *buffer, uint8_t &length) {
+  while (length < RX_LEN && this->uart_->available()) {
+    uint8_t byte;
+    this->uart_->read_byte(&byte);
+    // Resynchronise on the preamble, so a stray byte ahead of the reply does not drop the frame
+    if (length == 0 && byte != PREAMBLE)
+      continue;
+    buffer[length++] = byte;
+  }
+  // Replies have a fixed length, so the frame is complete once RX_LEN bytes are in;
+  // ParseResponse() then checks the prologue and CRC.
+  return length == RX_LEN;
+}
+
+#ifdef USE_ESP32
+void AirConditioner::start_bus_task_() {
+  // Pinned to the last core, next to the main loop and away from the WiFi stack on
+  // dual-core chips, at a priority above the loop so bus timing does not follow its stalls.
+  constexpr uint32_t BUS_TASK_STACK = 3072;
+  constexpr UBaseType_t BUS_TASK_PRIORITY = 5;
+  if (xTaskCreatePinnedToCore(AirConditioner::bus_task_, "midea_xye_bus", BUS_TASK_STACK, this, BUS_TASK_PRIORITY,
+                              &this->bus_task_handle_, portNUM_PROCESSORS - 1) != pdPASS) {
+    this->bus_task_handle_ = nullptr;
+    ESP_LOGE(Constants::TAG, "Could not start the bus task, using the main loop");
+  }
+}
+
+void AirConditioner::bus_task_(void *arg) { static_cast<AirConditioner *>(arg)->run_bus_(); }
+
+void AirConditioner::run_bus_() {
+  // No logging here: everything is reported from the main loop when the result is handled
+  BusRequest request;
+  BusResult result;
+  while (true) {
+    if (!this->bus_requests_.pop(request)) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      continue;
+    }
+    this->drain_rx_();
+    this->uart_->write_array(request.frame.raw, TX_LEN);
+    this->uart_->flush();
+    result.command = request.command;
+    result.length = 0;
+    const uint32_t started = millis();
+    while (!this->read_reply_(result.frame.raw, result.length) && millis() - started < this->response_timeout)
+      vTaskDelay(1);
+    this->bus_results_.push(result);
+  }
+}
+#endif
+
+void AirConditioner::handle_response_(uint8_t cmdSent, uint8_t length) {
+  if (length == RX_LEN) {
+    // Log incoming message at debug level
+    rx_data.print_debug(length, Constants::TAG, ESPHOME_LOG_LEVEL_DEBUG);
+    // SET and FOLLOW_ME are answered with the same status snapshot as a
+    // QUERY, so all three are decoded alike. Pending intents keep a reply
+    // that still shows the old state from overwriting what we just set.
+    const bool parsed = ParseResponse(cmdSent);
+    if (this->pending_static_pressure_.has_value() && this->mode != ClimateMode::CLIMATE_MODE_OFF) {
+      ESP_LOGW(Constants::TAG, "Unit switched on before static pressure %u was sent, dropping it",
+               *this->pending_static_pressure_);
+      this->pending_static_pressure_.reset();
+    }
+    if (queuedCommand != 0) {
+      controlState = queuedCommand;
+      queuedCommand = 0;
+    } else {
+      switch (cmdSent) {
+        case CLIENT_COMMAND_QUERY:
+          controlState = STATE_SEND_QUERY_EXTENDED;
+          break;
+        case CLIENT_COMMAND_SET:
+          // The reply already gave us the C0 snapshot, so skip straight to
+          // the extended query unless Follow-Me has to be refreshed first.
+          if ((this->follow_me_active_ && this->mode != ClimateMode::CLIMATE_MODE_OFF) ||
+              this->pending_static_pressure_.has_value()) {
             controlState = STATE_SEND_FOLLOWME;
-            break;
-          case CLIENT_COMMAND_QUERY_EXTENDED:
-            controlState = STATE_SEND_QUERY;
-            break;
-          case CLIENT_COMMAND_FOLLOWME:
-            controlState = STATE_SEND_QUERY;
-            break;
-        }
+          } else {
+            controlState = parsed ? STATE_SEND_QUERY_EXTENDED : STATE_SEND_QUERY;
+          }
+          break;
+        case CLIENT_COMMAND_QUERY_EXTENDED:
+          controlState = STATE_SEND_QUERY;
+          break;
+        case CLIENT_COMMAND_FOLLOWME:
+          controlState = parsed ? STATE_SEND_QUERY_EXTENDED : STATE_SEND_QUERY;
+          break;
       }
+    }
+  } else {
+    ESP_LOGE(Constants::TAG, "Received incorrect message length from AC for Command %02X", cmdSent);
+    rx_data.print_debug(length, Constants::TAG, ESPHOME_LOG_LEVEL_ERROR);
+    // Leave WAIT_DATA so the next poll retries instead of waiting for a reply that will not come
+    if (queuedCommand != 0) {
+      controlState = queuedCommand;
+      queuedCommand = 0;
     } else {
-      ESP_LOGE(Constants::TAG, "Received incorrect message length from AC for Command %02X", cmdSent);
-      rx_data.print_debug(i, Constants::TAG, ESPHOME_LOG_LEVEL_ERROR);
+      controlState = STATE_SEND_QUERY;
     }
-  });
+  }
 }
 
 void AirConditioner::update() {
@@ -245,22 +597,45 @@ void AirConditioner::update() {
       setACParams();
       cmdSent = CLIENT_COMMAND_SET;
       sendRecv(cmdSent);
+      this->mark_intents_sent_();
       break;
     }
     case STATE_SEND_FOLLOWME: {
       // If the AC mode changed, follow-me should be
       // refreshed, if emulating the wired controller's
-      // behavior.
+      // behavior. The frame is built here rather than when queued, so it
+      // can't be clobbered by a SET or QUERY sent in the meantime.
       cmdSent = CLIENT_COMMAND_FOLLOWME;
-      sendRecv(cmdSent);
-      if (this->mode == ClimateMode::CLIMATE_MODE_OFF) {
+      if (this->pending_static_pressure_.has_value() && this->mode == ClimateMode::CLIMATE_MODE_OFF) {
+        prepareStaticPressureTXData_(*this->pending_static_pressure_);
+        this->pending_static_pressure_.reset();
+        sendRecv(cmdSent);
         ESP_LOGI(Constants::TAG, "Set static pressure.");
+      } else if (!this->follow_me_active_) {
+        // No Follow-Me temperature has been supplied, so there is nothing to send
+        prepareTXData(CLIENT_COMMAND_QUERY);
+        cmdSent = CLIENT_COMMAND_QUERY;
+        sendRecv(cmdSent);
       } else {
+        prepareFollowMeTXData_();
+        sendRecv(cmdSent);
+        this->last_follow_me_sent_ = millis();
+        this->last_follow_me_sent_temperature_ = lastFollowMeTemperature;
         ESP_LOGI(Constants::TAG, "Sent Follow-Me data.");
       }
       break;
     }
     case STATE_SEND_QUERY: {
+      // Keep-alive: repeat the last Follow-Me value if nothing was sent for a while.
+      if (this->follow_me_due_()) {
+        cmdSent = CLIENT_COMMAND_FOLLOWME;
+        prepareFollowMeTXData_();
+        sendRecv(cmdSent);
+        this->last_follow_me_sent_ = millis();
+        this->last_follow_me_sent_temperature_ = lastFollowMeTemperature;
+        ESP_LOGD(Constants::TAG, "Sent Follow-Me keep-alive.");
+        break;
+      }
       // construct query command
       prepareTXData(CLIENT_COMMAND_QUERY);
       cmdSent = CLIENT_COMMAND_QUERY;
@@ -290,11 +665,14 @@ uint8_t AirConditioner::CalculateCRC(uint8_t *data, uint8_t len) {
   return 0xFF - (crc & 0xFF);
 }
 
-void AirConditioner::ParseResponse(uint8_t cmdSent) {
+bool AirConditioner::ParseResponse(uint8_t cmdSent) {
   // validate the response
   if ((RXData[RX_BYTE_PREAMBLE] == PREAMBLE) && (RXData[RX_BYTE_PROLOGUE] == PROLOGUE) &&
       (RXData[RX_BYTE_TO_CLIENT] == TO_CLIENT) && (RXData[RX_BYTE_CRC] == CalculateCRC(RXData, RX_LEN))) {
     switch (RXData[RX_BYTE_COMMAND_TYPE]) {
+      // SetResponseData and FollowMeResponseData share the QueryResponseData layout.
+      case CLIENT_COMMAND_SET:
+      case CLIENT_COMMAND_FOLLOWME:
       case CLIENT_COMMAND_QUERY: {
         ClimateMode mode = ClimateMode::CLIMATE_MODE_OFF;
         ClimateFanMode fan_mode = ClimateFanMode::CLIMATE_FAN_AUTO;
@@ -355,7 +733,20 @@ void AirConditioner::ParseResponse(uint8_t cmdSent) {
 
         bool need_publish = false;
 
-        update_property(this->mode, mode, need_publish);
+        const ClimateMode previous_mode = this->mode;
+        const bool mode_requested = this->mode_intent_.active;
+        if (this->reconcile_intent_(this->mode_intent_, this->mode, mode, "mode"))
+          update_property(this->mode, mode, need_publish);
+        if (!mode_requested && ForceReadNextCycle == 0 && this->mode != previous_mode)
+          this->unit_mode_change_callback_.call(this->mode);
+        // Setpoint, swing and preset are only reconciled while the unit is on. Once it
+        // settles off (mode rolled back, or switched off on the unit), drop them so they
+        // don't trigger stale re-sends when it comes back on.
+        if (mode == ClimateMode::CLIMATE_MODE_OFF && !this->mode_intent_.active) {
+          this->target_temperature_intent_.cancel();
+          this->swing_intent_.cancel();
+          this->preset_intent_.cancel();
+        }
         if (mode != ClimateMode::CLIMATE_MODE_OFF)  // Don't update below states
                                                     // unless mode is an ON state
         {
@@ -377,9 +768,17 @@ void AirConditioner::ParseResponse(uint8_t cmdSent) {
           // Update current_temperature based on sensor availability
           this->update_current_temperature_from_sensors_(need_publish);
 
+          this->reported_setpoint_ = RXData[RX_C0_BYTE_SET_TEMP];
 #ifndef SET_TARGET_TEMP_ON_QUERY
           // Target temperature always comes in as C, but user may want it in F.
-          update_property(this->target_temperature, static_cast<float>(RXData[RX_C0_BYTE_SET_TEMP]), need_publish);
+          float target_temperature = static_cast<float>(this->reported_setpoint_);
+          // C0 only carries whole degrees; take the half from the last C4 if it agrees.
+          if (this->uses_half_degree_() && !std::isnan(this->extended_target_temperature_) &&
+              floorf(this->extended_target_temperature_) == target_temperature)
+            target_temperature = this->extended_target_temperature_;
+          if (this->reconcile_intent_(this->target_temperature_intent_, this->target_temperature, target_temperature,
+                                      "target temperature"))
+            update_property(this->target_temperature, target_temperature, need_publish);
 #endif
 
           if ((this->mode == climate::CLIMATE_MODE_HEAT) && (RXData[RX_C0_BYTE_FAN_MODE] & 0x0F) != 0x00) {
@@ -414,15 +813,19 @@ void AirConditioner::ParseResponse(uint8_t cmdSent) {
             need_publish = true;
           }
 
-          if ((this->swing_mode != ClimateSwingMode::CLIMATE_SWING_OFF) !=
-              (bool) (RXData[RX_C0_BYTE_MODE_FLAGS] & MODE_FLAG_SWING))
-            need_publish = true;
-          this->swing_mode = (RXData[RX_C0_BYTE_MODE_FLAGS] & MODE_FLAG_SWING)
-                                 ? ClimateSwingMode::CLIMATE_SWING_VERTICAL
-                                 : ClimateSwingMode::CLIMATE_SWING_OFF;
-          if (this->preset != preset)
-            need_publish = true;
-          this->preset = preset;
+          const bool swing = (RXData[RX_C0_BYTE_MODE_FLAGS] & MODE_FLAG_SWING) != 0;
+          const bool current_swing = this->swing_mode != ClimateSwingMode::CLIMATE_SWING_OFF;
+          if (this->reconcile_intent_(this->swing_intent_, current_swing, swing, "swing")) {
+            if (current_swing != swing)
+              need_publish = true;
+            this->swing_mode = swing ? ClimateSwingMode::CLIMATE_SWING_VERTICAL : ClimateSwingMode::CLIMATE_SWING_OFF;
+          }
+          if (this->reconcile_intent_(this->preset_intent_, this->preset.value_or(ClimatePreset::CLIMATE_PRESET_NONE),
+                                      preset, "preset")) {
+            if (this->preset != preset)
+              need_publish = true;
+            this->preset = preset;
+          }
         } else if ((this->action != climate::CLIMATE_ACTION_IDLE) && (RXData[RX_C0_BYTE_FAN_MODE] & 0x0F) == 0x00) {
           this->action = climate::CLIMATE_ACTION_IDLE;
           need_publish = true;
@@ -435,18 +838,31 @@ void AirConditioner::ParseResponse(uint8_t cmdSent) {
         set_sensor(this->temperature_2b_sensor_, CalculateTemp(RXData[RX_C0_BYTE_T2B_TEMP]));
         set_sensor(this->temperature_3_sensor_, CalculateTemp(RXData[RX_C0_BYTE_T3_TEMP]));
         set_sensor(this->current_sensor_, RXData[RX_C0_BYTE_CURRENT]);
+        this->compressor_sample_.indoor_fan_on = (RXData[RX_C0_BYTE_FAN_MODE] & 0x0F) != 0x00;
+        this->compressor_sample_.heating = this->mode == ClimateMode::CLIMATE_MODE_HEAT;
+        // Many units never fill in the current byte and report 0xFF
+        this->power_inputs_.current_a =
+            RXData[RX_C0_BYTE_CURRENT] == 0xFF ? NAN : static_cast<float>(RXData[RX_C0_BYTE_CURRENT]);
+        this->power_inputs_.running = this->mode != ClimateMode::CLIMATE_MODE_OFF;
+        this->power_inputs_.heating = this->mode == ClimateMode::CLIMATE_MODE_HEAT;
+        this->update_energy_();
         set_sensor(this->timer_start_sensor_, CalculateGetTime(RXData[RX_C0_BYTE_TIMER_START]));
         set_sensor(this->timer_stop_sensor_, CalculateGetTime(RXData[RX_C0_BYTE_TIMER_STOP]));
         set_sensor(this->error_flags_sensor_,
                    (RXData[RX_C0_BYTE_ERROR_FLAGS1] << 0) | (RXData[RX_C0_BYTE_ERROR_FLAGS2] << 8));
         set_sensor(this->protect_flags_sensor_,
                    (RXData[RX_C0_BYTE_PROTECT_FLAGS1] << 0) | (RXData[RX_C0_BYTE_PROTECT_FLAGS2] << 8));
+        this->update_faults_((RXData[RX_C0_BYTE_ERROR_FLAGS1] << 0) | (RXData[RX_C0_BYTE_ERROR_FLAGS2] << 8),
+                             (RXData[RX_C0_BYTE_PROTECT_FLAGS1] << 0) | (RXData[RX_C0_BYTE_PROTECT_FLAGS2] << 8));
+        this->save_faults_();
         break;
       }
       case CLIENT_COMMAND_QUERY_EXTENDED:
         bool need_publish = false;
         set_sensor(this->outdoor_sensor_, CalculateTemp(RXData[RX_C4_BYTE_OUTDOOR_SENSOR]));
         set_number(this->static_pressure_number_, 0x0F & RXData[RX_C4_BYTE_STATIC_PRESSURE]);
+        this->probe_temperature_resolution_(rx_data.message.data.extended_query_response);
+        this->publish_engineering_(rx_data.message.data.extended_query_response);
 #ifdef SET_TARGET_TEMP_ON_EXTENDED_QUERY
         if (mode != ClimateMode::CLIMATE_MODE_OFF ||
             ForceReadNextCycle == 1)  // Don't update below states unless mode is an ON state
@@ -477,9 +893,12 @@ void AirConditioner::ParseResponse(uint8_t cmdSent) {
         ForceReadNextCycle = 0;
         break;
     }
+    this->frame_callback_.call(this->rx_data);
+    return true;
   } else {
     ESP_LOGE(Constants::TAG, "Received invalid response from AC");
     rx_data.print_debug(RX_MESSAGE_LENGTH, Constants::TAG, ESPHOME_LOG_LEVEL_ERROR);
+    return false;
   }
 }
 
@@ -545,6 +964,40 @@ uint32_t AirConditioner::CalculateGetTime(uint8_t time) {
   return timeValue;
 }
 
+void AirConditioner::publish_engineering_(const ExtendedQueryResponseData &data) {
+  // Flag fields are bitmasks: only bit 7 has a confirmed meaning, the raw value is published for triage
+  constexpr uint8_t BIT_ACTIVE = 0x80;
+  set_sensor(this->indoor_fan_pwm_sensor_, data.indoor_fan_pwm);
+  set_sensor(this->indoor_fan_tach_sensor_, data.indoor_fan_tach);
+  set_sensor(this->compressor_flags_sensor_, static_cast<uint8_t>(data.compressor_flags));
+  set_sensor(this->esp_profile_sensor_, static_cast<uint8_t>(data.esp_profile));
+  set_sensor(this->protection_flags_sensor_, static_cast<uint8_t>(data.protection_flags));
+  // 0x00 means the unit does not report the discharge temperature
+  if (data.discharge_temp.value != 0x00)
+    set_sensor(this->discharge_temperature_sensor_, CalculateTemp(data.discharge_temp.value));
+  set_sensor(this->expansion_valve_position_sensor_, data.expansion_valve_pos);
+  set_sensor(this->compressor_frequency_sensor_, data.compressor_freq_or_fan_rpm.value());
+  this->power_inputs_.compressor_hz = data.compressor_freq_or_fan_rpm.value();
+  this->power_inputs_.fan_duty = data.indoor_fan_pwm / 255.0f;
+
+  this->compressor_sample_.compressor_on = static_cast<uint8_t>(data.compressor_flags) & BIT_ACTIVE;
+  this->compressor_sample_.outdoor_fan_on = static_cast<uint8_t>(data.protection_flags) & BIT_ACTIVE;
+  this->update_compressor_();
+
+  set_binary_sensor(this->compressor_running_binary_sensor_,
+                    static_cast<uint8_t>(data.compressor_flags) & BIT_ACTIVE);
+  set_binary_sensor(this->outdoor_fan_running_binary_sensor_,
+                    static_cast<uint8_t>(data.protection_flags) & BIT_ACTIVE);
+  set_binary_sensor(this->compressor_ok_binary_sensor_,
+                    static_cast<uint8_t>(data.subsystem_ok_compressor) & BIT_ACTIVE);
+  set_binary_sensor(this->outdoor_fan_ok_binary_sensor_,
+                    static_cast<uint8_t>(data.subsystem_ok_outdoor_fan) & BIT_ACTIVE);
+  set_binary_sensor(this->four_way_valve_ok_binary_sensor_,
+                    static_cast<uint8_t>(data.subsystem_ok_4way_valve) & BIT_ACTIVE);
+  set_binary_sensor(this->inverter_ok_binary_sensor_,
+                    static_cast<uint8_t>(data.subsystem_ok_inverter) & BIT_ACTIVE);
+}
+
 float AirConditioner::CalculateTemp(uint8_t byte) { return (byte - 0x28) / 2.0; }
 
 climate::ClimateTraits AirConditioner::traits() {
@@ -553,7 +1006,7 @@ climate::ClimateTraits AirConditioner::traits() {
   traits.add_feature_flags(climate::CLIMATE_SUPPORTS_ACTION);
   traits.set_visual_min_temperature(17);
   traits.set_visual_max_temperature(30);
-  traits.set_visual_temperature_step(1.0);
+  traits.set_visual_temperature_step(this->uses_half_degree_() ? 0.5f : 1.0f);
   traits.set_supported_modes(this->supported_modes_);
   traits.set_supported_swing_modes(this->supported_swing_modes_);
   traits.set_supported_presets(this->supported_presets_);
@@ -580,7 +1033,30 @@ void AirConditioner::dump_config() {
   ESP_LOGCONFIG(Constants::TAG, "MideaXYE:");
   ESP_LOGCONFIG(Constants::TAG, "  [x] Period: %dms", this->get_update_interval());
   ESP_LOGCONFIG(Constants::TAG, "  [x] Response timeout: %dms", this->response_timeout);
+  ESP_LOGCONFIG(Constants::TAG, "  [x] Frame transmit time: %ums", this->tx_time_);
+#ifdef USE_ESP32
+  ESP_LOGCONFIG(Constants::TAG, "  [x] Bus task: %s", this->bus_task_handle_ != nullptr ? "yes" : "no");
+#endif
+  ESP_LOGCONFIG(Constants::TAG, "  [x] Control settle time: %ums", this->control_settle_time_);
+  ESP_LOGCONFIG(Constants::TAG, "  [x] Intent confirmation: %u cycles, %u retries", this->intent_confirm_cycles_,
+                this->intent_max_retries_);
   ESP_LOGCONFIG(Constants::TAG, "  [x] Use Fahrenheit: %d", this->use_fahrenheit_);
+  ESP_LOGCONFIG(Constants::TAG, "  [x] Follow-Me keep-alive: %ums", this->follow_me_keepalive_);
+  ESP_LOGCONFIG(Constants::TAG, "  [x] Half-degree resolution: %s", this->uses_half_degree_() ? "yes" : "no");
+
+  const FaultHistory &history = this->faults_.history();
+  for (uint8_t i = 0; i < history.count; i++) {
+    const FaultEvent &event = history.events[i];
+    const FaultCode &fault = FaultDecoder::code(event.index);
+    ESP_LOGCONFIG(Constants::TAG, "  [x] Past fault: %s (%s) at %u, uptime %us", fault.code, fault.description,
+                  event.epoch, event.uptime_s);
+  }
+  // Transitions since boot, most recent first (shown again whenever a log client connects)
+  for (uint8_t i = 0; i < this->faults_.event_count(); i++) {
+    const FaultEvent &event = this->faults_.event(i);
+    ESP_LOGCONFIG(Constants::TAG, "  [x] Fault %s %s at %u, uptime %us", FaultDecoder::code(event.index).code,
+                  event.active ? "set" : "cleared", event.epoch, event.uptime_s);
+  }
 
 #ifdef USE_REMOTE_TRANSMITTER
   ESP_LOGCONFIG(Constants::TAG, "  [x] Using RemoteTransmitter");
@@ -595,9 +1071,22 @@ void AirConditioner::do_follow_me(float temperature, bool beeper) {
   IrFollowMeData data(static_cast<uint8_t>(lroundf(temperature)), beeper);
   this->transmitter_.transmit(data);
 #else
+  // The frame itself is built in update() right before it is sent.
+  lastFollowMeTemperature = this->encode_follow_me_temperature_(temperature);
+  this->follow_me_active_ = true;
+  // Only send if mode is something other than off.
+  // Wired controller does not send Follow-Me command when off.
+  if (this->mode != ClimateMode::CLIMATE_MODE_OFF) {
+    this->queue_command_(STATE_SEND_FOLLOWME);
+    ESP_LOGI(Constants::TAG, "Queued Follow-Me data.");
+  }
+#endif
+}
+
+void AirConditioner::prepareFollowMeTXData_() {
   // Prepare Follow-Me command for temperature update
   prepareTXData(CLIENT_COMMAND_FOLLOWME);
-  
+
   // TXData[10] is a subcommand type field for Follow-Me commands.
   // Subcommand values: 0x06=Init, 0x02=Update, 0x04=Static pressure
   // The followMeInit flag tracks whether we've sent the initialization command.
@@ -609,41 +1098,28 @@ void AirConditioner::do_follow_me(float temperature, bool beeper) {
     TXData[10] = FOLLOWME_SUBCOMMAND_INIT;  // Follow-Me initialization
     followMeInit = true;
   }
-  lastFollowMeTemperature = static_cast<uint8_t>(lroundf(temperature));
   TXData[11] = lastFollowMeTemperature;
   TXData[14] = CalculateCRC(TXData, TX_LEN);
-  // Only send if mode is something other than off.
-  // Wired controller does not send Follow-Me command when off.
-  if (this->mode != ClimateMode::CLIMATE_MODE_OFF) {
-    if (controlState != STATE_WAIT_DATA) {
-      controlState = STATE_SEND_FOLLOWME;
-    } else {
-      queuedCommand = STATE_SEND_FOLLOWME;
-    }
-    ESP_LOGI(Constants::TAG, "Queued Follow-Me data.");
-  }
-#endif
 }
 
-void AirConditioner::set_static_pressure(uint8_t static_pressure) {
-  if (static_pressure > 15) {
-    ESP_LOGW(Constants::TAG, "Cannot set static pressure %d > 15", static_pressure);
-    return;
-  }
-
+void AirConditioner::prepareStaticPressureTXData_(uint8_t static_pressure) {
   // Prepare Follow-Me command for static pressure setting
   prepareTXData(CLIENT_COMMAND_FOLLOWME);
   TXData[8] = 0x10 | (static_pressure & 0x0F);
   TXData[10] = FOLLOWME_SUBCOMMAND_STATIC_PRESSURE;  // Subcommand type: Static pressure setting
   TXData[11] = lastFollowMeTemperature;
   TXData[14] = CalculateCRC(TXData, TX_LEN);
+}
+
+void AirConditioner::set_static_pressure(uint8_t static_pressure) {
+  if (static_pressure > 15) {
+    ESP_LOGW(Constants::TAG, "Cannot set static pressure %d > 15", static_pressure);
+    return;
+  }
 
   if (this->mode == ClimateMode::CLIMATE_MODE_OFF) {
-    if (controlState != STATE_WAIT_DATA) {
-      controlState = STATE_SEND_FOLLOWME;
-    } else {
-      queuedCommand = STATE_SEND_FOLLOWME;
-    }
+    this->pending_static_pressure_ = static_pressure;
+    this->queue_command_(STATE_SEND_FOLLOWME);
     ESP_LOGI(Constants::TAG, "Queued setting static pressure to %d", static_pressure);
   } else {
     ESP_LOGW(Constants::TAG, "Cannot set static pressure while unit is running");
@@ -680,10 +1156,74 @@ void AirConditioner::on_follow_me_sensor_update_(float state) {
     this->publish_state();
   }
 
+  // Governor: only queue a C6 frame when it carries new information. Jitter
+  // below the unit's resolution (whole or half degree) from chatty sensors is
+  // dropped and the keep-alive in update() takes care of refreshing an
+  // unchanged value. An INIT after a mode change always goes out.
+  const uint8_t temperature = this->encode_follow_me_temperature_(state);
+  if (followMeInit && this->follow_me_active_ && temperature == this->last_follow_me_sent_temperature_) {
+    lastFollowMeTemperature = temperature;
+    return;
+  }
+
   // Send follow_me command with the sensor temperature
   this->do_follow_me(state, false);
 }
 
+bool AirConditioner::uses_half_degree_() const {
+  if (this->use_fahrenheit_)
+    return false;
+  return this->temperature_resolution_ == TemperatureResolution::HALF ||
+         (this->temperature_resolution_ == TemperatureResolution::AUTO && this->half_degree_detected_);
+}
+
+bool AirConditioner::half_degree_probe_due_() const {
+  // Only a setpoint with a half degree tells a unit that keeps it from one that mirrors whole degrees
+  if (this->temperature_resolution_ != TemperatureResolution::AUTO || this->half_degree_probed_ ||
+      this->use_fahrenheit_ || this->mode == ClimateMode::CLIMATE_MODE_OFF || std::isnan(this->target_temperature))
+    return false;
+  return (lroundf(this->target_temperature * 2.0f) & 1) != 0;
+}
+
+uint8_t AirConditioner::encode_follow_me_temperature_(float temperature) const {
+  if (this->uses_half_degree_()) {
+    // Encoded values start at 0x28 (0 °C), above the raw 0-37 °C range.
+    const float clamped = std::max(0.0f, std::min(temperature, 37.0f));
+    return Temperature::from_celsius(roundf(clamped * 2.0f) / 2.0f).value;
+  }
+  return static_cast<uint8_t>(lroundf(temperature));
+}
+
+void AirConditioner::probe_temperature_resolution_(const ExtendedQueryResponseData &data) {
+  this->extended_target_temperature_ = data.target_temperature.to_celsius();
+  if (std::isnan(this->half_degree_probe_))
+    return;
+  // C4 byte 18 mirrors the setpoint in encoded form on most units, so a whole
+  // degree there proves nothing. Only a unit that kept the half degree of the
+  // encoded SET supports it.
+  const float probe = this->half_degree_probe_;
+  this->half_degree_probe_ = NAN;
+  this->half_degree_probed_ = true;
+  if (std::fabs(this->extended_target_temperature_ - probe) > 0.25f) {
+    ESP_LOGI(Constants::TAG, "Unit did not keep the %.1f °C setpoint, staying on 1 °C resolution", probe);
+    // Re-send the setpoint in the raw form the unit understands
+    this->queue_command_(STATE_SEND_SET);
+    return;
+  }
+  this->half_degree_detected_ = true;
+  ESP_LOGI(Constants::TAG, "Unit kept the %.1f °C setpoint, using 0.5 °C resolution", probe);
+  // Re-encode the current Follow-Me value so keep-alives use the new form.
+  if (this->follow_me_sensor_ != nullptr && this->follow_me_sensor_->has_state() &&
+      !std::isnan(this->follow_me_sensor_->state))
+    lastFollowMeTemperature = this->encode_follow_me_temperature_(this->follow_me_sensor_->state);
+}
+
+bool AirConditioner::follow_me_due_() const {
+  if (!this->follow_me_active_ || this->mode == ClimateMode::CLIMATE_MODE_OFF)
+    return false;
+  return (millis() - this->last_follow_me_sent_) >= this->follow_me_keepalive_;
+}
+
 void AirConditioner::update_current_temperature_from_sensors_(bool &need_publish) {
   // Use follow_me_sensor as current_temperature if available, otherwise use internal temperature
   if (this->follow_me_sensor_ != nullptr && this->follow_me_sensor_->has_state() &&
@@ -697,5 +1237,3 @@ void AirConditioner::update_current_temperature_from_sensors_(bool &need_publish
 }  // namespace xye
 }  // namespace midea
 }  // namespace esphome
-
-#endif  // USE_ARDUINO
@@ -1,16 +1,26 @@
 #pragma once
 
-#ifdef USE_ARDUINO
-
+#include "esphome/components/binary_sensor/binary_sensor.h"
 #include "esphome/components/climate/climate.h"
 #include "esphome/components/climate/climate_traits.h"
 #include "esphome/components/number/number.h"
 #include "esphome/components/sensor/sensor.h"
+#include "esphome/components/text_sensor/text_sensor.h"
 #include "esphome/components/uart/uart.h"
 #include "esphome/core/component.h"
 #include "esphome/core/defines.h"
 #include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+#include "compressor_analytics.h"
+#include "energy_estimator.h"
+#include "fault_decoder.h"
 #include "ir_transmitter.h"
+#include "pending_intent.h"
+#include "spsc_queue.h"
 #include "static_pressure_number.h"
 #include "xye.h"
 #include "xye_send.h"
@@ -158,6 +168,16 @@ using climate::ClimateMode;
 using climate::ClimatePreset;
 using climate::ClimateSwingMode;
 using sensor::Sensor;
+using binary_sensor::BinarySensor;
+
+/**
+ * @brief Setpoint and Follow-Me resolution
+ */
+enum class TemperatureResolution : uint8_t {
+  AUTO = 0,   ///< Send the first half-degree setpoint encoded and switch to half degrees if the unit keeps it
+  WHOLE = 1,  ///< Whole degrees, raw Celsius on the wire (classic behavior, default)
+  HALF = 2    ///< Half degrees, encoded as (celsius * 2) + 0x28 on the wire
+};
 
 class Constants {
  public:
@@ -167,6 +187,12 @@ class Constants {
   static const char *const TURBO;
 };
 
+/// Persisted energy total and power model, see EnergyEstimator
+struct EnergyRestoreState {
+  double energy_kwh;
+  float coefficients[EnergyEstimator::FEATURES];
+} __attribute__((packed));
+
 class AirConditioner : public PollingComponent, public climate::Climate, public StaticPressureInterface {
  public:
   AirConditioner() : PollingComponent(1000) { this->response_timeout = 100; }
@@ -180,6 +206,13 @@ class AirConditioner : public PollingComponent, public climate::Climate, public
   void set_uart_parent(uart::UARTComponent *parent) { this->uart_ = parent; }
   void set_period(uint32_t ms) { this->set_update_interval(ms); }
   void set_response_timeout(uint32_t ms) { this->response_timeout = ms; }
+  void set_control_settle_time(uint32_t ms) { this->control_settle_time_ = ms; }
+  void set_intent_confirm_cycles(uint8_t cycles) { this->intent_confirm_cycles_ = cycles; }
+  void set_intent_max_retries(uint8_t retries) { this->intent_max_retries_ = retries; }
+#ifdef USE_ESP32
+  /// Run the bus I/O in a dedicated FreeRTOS task instead of the main loop
+  void set_bus_task(bool enabled) { this->use_bus_task_ = enabled; }
+#endif
 
   /* Component methods */
 
@@ -198,8 +231,61 @@ class AirConditioner : public PollingComponent, public climate::Climate, public
   void set_humidity_setpoint_sensor(Sensor *sensor) { this->humidity_sensor_ = sensor; }
   void set_power_sensor(Sensor *sensor) { this->power_sensor_ = sensor; }
   void set_follow_me_sensor(Sensor *sensor);
+  void set_follow_me_keepalive(uint32_t ms) { this->follow_me_keepalive_ = ms; }
   void set_internal_current_temperature_sensor(Sensor *sensor) { this->internal_current_temperature_sensor_ = sensor; }
+  void set_confirmation_latency_sensor(Sensor *sensor) { this->confirmation_latency_sensor_ = sensor; }
+  // Power/energy estimation
+  void set_energy_sensor(Sensor *sensor) { this->energy_sensor_ = sensor; }
+  void set_power_reference_sensor(Sensor *sensor);
+  // Error/protection codes
+  void set_error_codes_text_sensor(text_sensor::TextSensor *sensor) {
+    this->error_codes_text_sensor_ = sensor;
+    this->fault_persist_ = true;
+  }
+  /// Called with the code ("E1", "P4", ...) of every fault that becomes active
+  void add_on_error_callback(std::function<void(const std::string &)> &&callback) {
+    this->error_callback_.add(std::move(callback));
+    this->fault_persist_ = true;
+  }
+  const FaultDecoder &get_faults() const { return this->faults_; }
+  // Hardware events, fired from the decode path
+  /// Called with the CompressorEvent bits raised by each C4 snapshot
+  void add_on_compressor_event_callback(std::function<void(uint8_t)> &&callback) {
+    this->compressor_event_callback_.add(std::move(callback));
+  }
+  /// Called when the unit reports a mode we did not request (wired controller, IR remote)
+  void add_on_unit_mode_change_callback(std::function<void(ClimateMode)> &&callback) {
+    this->unit_mode_change_callback_.add(std::move(callback));
+  }
+  /// Called with every valid response, after it has been decoded
+  void add_on_frame_callback(std::function<void(const ReceiveData &)> &&callback) {
+    this->frame_callback_.add(std::move(callback));
+  }
+  // Compressor analytics
+  void set_short_cycle_time(uint32_t ms) { this->compressor_.set_short_cycle_threshold(ms); }
+  void set_compressor_run_time_sensor(Sensor *sensor) { this->compressor_run_time_sensor_ = sensor; }
+  void set_compressor_starts_sensor(Sensor *sensor) { this->compressor_starts_sensor_ = sensor; }
+  void set_defrost_count_sensor(Sensor *sensor) { this->defrost_count_sensor_ = sensor; }
+  void set_short_cycles_sensor(Sensor *sensor) { this->short_cycles_sensor_ = sensor; }
+  void set_last_cycle_duration_sensor(Sensor *sensor) { this->last_cycle_duration_sensor_ = sensor; }
+  void set_average_cycle_duration_sensor(Sensor *sensor) { this->average_cycle_duration_sensor_ = sensor; }
+  // C4 engineering fields
+  void set_indoor_fan_pwm_sensor(Sensor *sensor) { this->indoor_fan_pwm_sensor_ = sensor; }
+  void set_indoor_fan_tach_sensor(Sensor *sensor) { this->indoor_fan_tach_sensor_ = sensor; }
+  void set_compressor_flags_sensor(Sensor *sensor) { this->compressor_flags_sensor_ = sensor; }
+  void set_esp_profile_sensor(Sensor *sensor) { this->esp_profile_sensor_ = sensor; }
+  void set_protection_flags_sensor(Sensor *sensor) { this->protection_flags_sensor_ = sensor; }
+  void set_discharge_temperature_sensor(Sensor *sensor) { this->discharge_temperature_sensor_ = sensor; }
+  void set_expansion_valve_position_sensor(Sensor *sensor) { this->expansion_valve_position_sensor_ = sensor; }
+  void set_compressor_frequency_sensor(Sensor *sensor) { this->compressor_frequency_sensor_ = sensor; }
+  void set_compressor_running_binary_sensor(BinarySensor *sensor) { this->compressor_running_binary_sensor_ = sensor; }
+  void set_outdoor_fan_running_binary_sensor(BinarySensor *sensor) { this->outdoor_fan_running_binary_sensor_ = sensor; }
+  void set_compressor_ok_binary_sensor(BinarySensor *sensor) { this->compressor_ok_binary_sensor_ = sensor; }
+  void set_outdoor_fan_ok_binary_sensor(BinarySensor *sensor) { this->outdoor_fan_ok_binary_sensor_ = sensor; }
+  void set_four_way_valve_ok_binary_sensor(BinarySensor *sensor) { this->four_way_valve_ok_binary_sensor_ = sensor; }
+  void set_inverter_ok_binary_sensor(BinarySensor *sensor) { this->inverter_ok_binary_sensor_ = sensor; }
   void set_use_fahrenheit(bool yesno) { this->use_fahrenheit_ = yesno; }
+  void set_temperature_resolution(TemperatureResolution resolution) { this->temperature_resolution_ = resolution; }
   void set_static_pressure_number(StaticPressureNumber *number) {
     this->static_pressure_number_ = number;
     number->set_parent(this);
@@ -208,7 +294,7 @@ class AirConditioner : public PollingComponent, public climate::Climate, public
   void update() override;
   void prepareTXData(uint8_t command);
   void setup() override;
-  void loop() override {}
+  void loop() override;
   void sendRecv(uint8_t cmdSent);
   void setPowerState(bool state);
   void setACParams();
@@ -245,11 +331,62 @@ class AirConditioner : public PollingComponent, public climate::Climate, public
   uint8_t ForceReadNextCycle;
   uint8_t queuedCommand;
   uint32_t response_timeout;
+  // Reply being collected by loop(); the wait ends at RX_LEN bytes or after
+  // tx_time_ + response_timeout counted from rx_started_at_ (when the request was written)
+  uint8_t rx_command_{0};
+  uint8_t rx_length_{0};
+  uint32_t rx_started_at_{0};
+  // Time our request takes on the wire, from the UART settings
+  uint32_t tx_time_{0};
+  // Runs loop() back to back while a reply is expected, so it is handled as soon as it is complete
+  HighFrequencyLoopRequester high_freq_;
+#ifdef USE_ESP32
+  // Optional bus task: it owns the UART and runs each transaction (send, wait, collect)
+  // on its own timing; requests and replies cross over in lock-free SPSC queues.
+  struct BusRequest {
+    uint8_t command;
+    TransmitData frame;
+  };
+  struct BusResult {
+    uint8_t command;
+    uint8_t length;
+    ReceiveData frame;
+  };
+  bool use_bus_task_{false};
+  TaskHandle_t bus_task_handle_{nullptr};
+  SpscQueue<BusRequest, 4> bus_requests_;
+  SpscQueue<BusResult, 4> bus_results_;
+#endif
   // Tracks whether Follow-Me has been initialized after mode change.
   // When false, next Follow-Me update sends initialization (TXData[10]=6).
   // When true, Follow-Me updates send regular update (TXData[10]=2).
   bool followMeInit;
-  uint8_t lastFollowMeTemperature;
+  uint8_t lastFollowMeTemperature{0};
+  // Set once a Follow-Me temperature has been supplied; the wired controller
+  // re-sends Follow-Me after every SET, so we do the same from then on.
+  bool follow_me_active_{false};
+  // Follow-Me governor: sensor updates only produce a C6 frame when the whole-degree
+  // value changes; otherwise the last value is repeated once per keep-alive interval
+  // so the unit does not fall back to T1.
+  uint32_t follow_me_keepalive_{30000};
+  uint32_t last_follow_me_sent_{0};
+  uint8_t last_follow_me_sent_temperature_{0};
+  // Static pressure waiting to go out in a Follow-Me frame (unit must be off).
+  // Dropped if the unit is switched on before it went out.
+  optional<uint8_t> pending_static_pressure_{};
+  // Settle window for coalescing bursts of control() calls into a single SET.
+  // 0 disables coalescing and arms the SET immediately.
+  uint32_t control_settle_time_{0};
+  bool control_settle_pending_{false};
+  // Values requested from the unit that no C0 snapshot has confirmed yet.
+  // While pending, snapshots do not overwrite the optimistic state.
+  // Fan mode is not tracked since the unit does not report it reliably.
+  PendingIntent<ClimateMode> mode_intent_;
+  PendingIntent<float> target_temperature_intent_;
+  PendingIntent<bool> swing_intent_;
+  PendingIntent<ClimatePreset> preset_intent_;
+  uint8_t intent_confirm_cycles_{3};
+  uint8_t intent_max_retries_{1};
 
  protected:
   uart::UARTComponent *uart_;
@@ -264,6 +401,16 @@ class AirConditioner : public PollingComponent, public climate::Climate, public
   std::vector<const char *> supported_custom_presets_{};
   std::vector<const char *> supported_custom_fan_modes_{};
   bool use_fahrenheit_;
+  TemperatureResolution temperature_resolution_{TemperatureResolution::WHOLE};
+  // Set by the capability probe in AUTO mode once the unit has kept a half-degree
+  // setpoint sent in the encoded form.
+  bool half_degree_detected_{false};
+  // AUTO probe: the encoded half-degree setpoint awaiting the unit's C4 echo (NaN = none)
+  float half_degree_probe_{NAN};
+  bool half_degree_probed_{false};  ///< The probe has concluded, either way
+  // Last setpoint from C4 in encoded form, used to recover the half degree the C0 field drops.
+  float extended_target_temperature_{NAN};
+  uint8_t reported_setpoint_{0};  ///< Last whole-degree setpoint from C0
   Sensor *outdoor_sensor_{nullptr};
   Sensor *temperature_2a_sensor_{nullptr};
   Sensor *temperature_2b_sensor_{nullptr};
@@ -277,21 +424,98 @@ class AirConditioner : public PollingComponent, public climate::Climate, public
   Sensor *power_sensor_{nullptr};
   Sensor *follow_me_sensor_{nullptr};
   Sensor *internal_current_temperature_sensor_{nullptr};
+  Sensor *confirmation_latency_sensor_{nullptr};
+  Sensor *energy_sensor_{nullptr};
+  Sensor *compressor_run_time_sensor_{nullptr};
+  Sensor *compressor_starts_sensor_{nullptr};
+  Sensor *defrost_count_sensor_{nullptr};
+  Sensor *short_cycles_sensor_{nullptr};
+  Sensor *last_cycle_duration_sensor_{nullptr};
+  Sensor *average_cycle_duration_sensor_{nullptr};
+  Sensor *indoor_fan_pwm_sensor_{nullptr};
+  Sensor *indoor_fan_tach_sensor_{nullptr};
+  Sensor *compressor_flags_sensor_{nullptr};
+  Sensor *esp_profile_sensor_{nullptr};
+  Sensor *protection_flags_sensor_{nullptr};
+  Sensor *discharge_temperature_sensor_{nullptr};
+  Sensor *expansion_valve_position_sensor_{nullptr};
+  Sensor *compressor_frequency_sensor_{nullptr};
+  BinarySensor *compressor_running_binary_sensor_{nullptr};
+  BinarySensor *outdoor_fan_running_binary_sensor_{nullptr};
+  BinarySensor *compressor_ok_binary_sensor_{nullptr};
+  BinarySensor *outdoor_fan_ok_binary_sensor_{nullptr};
+  BinarySensor *four_way_valve_ok_binary_sensor_{nullptr};
+  BinarySensor *inverter_ok_binary_sensor_{nullptr};
   StaticPressureNumber *static_pressure_number_{nullptr};
   ClimateMode last_on_mode_;
   float internal_temperature_{NAN};
 
   static uint8_t CalculateCRC(uint8_t *Data, uint8_t len);
-  void ParseResponse(uint8_t cmdSent);
+  bool ParseResponse(uint8_t cmdSent);
+  void handle_response_(uint8_t cmdSent, uint8_t length);
+  void drain_rx_();
+  /// Appends the available bytes of a reply to buffer; true once the frame is complete
+  bool read_reply_(uint8_t *buffer, uint8_t &length);
+  uint32_t frame_time_ms_(uint8_t bytes) const;
+#ifdef USE_ESP32
+  void start_bus_task_();
+  static void bus_task_(void *arg);
+  void run_bus_();
+#endif
   uint8_t CalculateSetTime(uint32_t time);
   uint32_t CalculateGetTime(uint8_t time);
   static float CalculateTemp(uint8_t byte);
   void update_current_temperature_from_sensors_(bool &need_publish);
+  void queue_command_(uint8_t state);
+  void prepareFollowMeTXData_();
+  void prepareStaticPressureTXData_(uint8_t static_pressure);
+  void queue_set_();
+  void mark_intents_sent_();
+  template<typename T>
+  bool reconcile_intent_(PendingIntent<T> &intent, const T &current, const T &reported, const char *field);
   void on_follow_me_sensor_update_(float state);
+  bool follow_me_due_() const;
+  bool uses_half_degree_() const;
+  bool half_degree_probe_due_() const;
+  uint8_t encode_follow_me_temperature_(float temperature) const;
+  void probe_temperature_resolution_(const ExtendedQueryResponseData &data);
+  void publish_engineering_(const ExtendedQueryResponseData &data);
+
+  // Power/energy estimation: inputs are cached from C0 and C4, integrated on every C0
+  void update_energy_();
+  void save_energy_();
+  EnergyEstimator energy_;
+  PowerInputs power_inputs_;
+  ESPPreferenceObject energy_pref_;
+  bool energy_dirty_{false};
+  uint32_t energy_saved_at_{0};
+
+  // Compressor analytics: fan bits cached from C0, fed on every C4
+  void update_compressor_();
+  CompressorAnalytics compressor_;
+  CompressorSample compressor_sample_;
+  ESPPreferenceObject compressor_pref_;
+  bool compressor_persist_{false};
+  bool compressor_dirty_{false};
+  uint32_t compressor_saved_at_{0};
+
+  // Error/protection decoding, run on every C0
+  void update_faults_(uint16_t errors, uint16_t protections);
+  void save_faults_();
+  FaultDecoder faults_;
+  ESPPreferenceObject fault_pref_;
+  // Fault history is only kept in flash when error_codes or on_error is configured
+  bool fault_persist_{false};
+  bool fault_dirty_{false};
+  uint32_t fault_saved_at_{0};
+  text_sensor::TextSensor *error_codes_text_sensor_{nullptr};
+  CallbackManager<void(const std::string &)> error_callback_;
+
+  CallbackManager<void(uint8_t)> compressor_event_callback_;
+  CallbackManager<void(ClimateMode)> unit_mode_change_callback_;
+  CallbackManager<void(const ReceiveData &)> frame_callback_;
 };
 
 }  // namespace xye
 }  // namespace midea
 }  // namespace esphome
-
-#endif  // USE_ARDUINO
@@ -1,6 +1,6 @@
 from esphome.core import coroutine
 from esphome import automation
-from esphome.components import climate, sensor, uart, remote_transmitter, number
+from esphome.components import binary_sensor, climate, sensor, text_sensor, uart, remote_transmitter, number
 from esphome.components.remote_base import CONF_TRANSMITTER_ID
 import esphome.config_validation as cv
 import esphome.codegen as cg
@@ -21,23 +21,34 @@ from esphome.const import (
     CONF_MIN_VALUE,
     CONF_ICON,
     CONF_MODE,
+    CONF_TRIGGER_ID,
     DEVICE_CLASS_POWER,
     DEVICE_CLASS_TEMPERATURE,
     DEVICE_CLASS_HUMIDITY,
     DEVICE_CLASS_DURATION,
     DEVICE_CLASS_EMPTY,
+    DEVICE_CLASS_ENERGY,
+    DEVICE_CLASS_RUNNING,
+    ENTITY_CATEGORY_DIAGNOSTIC,
     ICON_POWER,
     ICON_THERMOMETER,
     ICON_WATER_PERCENT,
     ICON_TIMER,
     ICON_BUG,
     ICON_SECURITY,
+    ICON_FAN,
+    ICON_GAUGE,
+    ICON_COUNTER,
     STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
     UNIT_CELSIUS,
     UNIT_PERCENT,
     UNIT_WATT,
+    UNIT_KILOWATT_HOURS,
+    UNIT_HOUR,
     UNIT_AMPERE,
     UNIT_MINUTE,
+    UNIT_MILLISECOND,
     UNIT_EMPTY,
 )
 from esphome.components.climate import (
@@ -48,7 +59,7 @@ from esphome.components.climate import (
 
 #CODEOWNERS = ["@dudanov"]
 DEPENDENCIES = ["climate", "uart", "wifi"]
-AUTO_LOAD = ["number", "sensor"]
+AUTO_LOAD = ["binary_sensor", "number", "sensor", "text_sensor"]
 CONF_OUTDOOR_TEMPERATURE = "outdoor_temperature"
 CONF_TEMPERATURE_2A = "temperature_2a"
 CONF_TEMPERATURE_2B = "temperature_2b"
@@ -59,14 +70,66 @@ CONF_TIMER_STOP = "timer_stop"
 CONF_ERROR_FLAGS = "error_flags"
 CONF_PROTECT_FLAGS = "protect_flags"
 CONF_POWER_USAGE = "power_usage"
+CONF_ENERGY = "energy"
+CONF_POWER_REFERENCE_SENSOR = "power_reference_sensor"
 CONF_HUMIDITY_SETPOINT = "humidity_setpoint"
 CONF_STATIC_PRESSURE = "static_pressure"
 CONF_FOLLOW_ME_SENSOR = "follow_me_sensor"
+CONF_FOLLOW_ME_KEEPALIVE = "follow_me_keepalive"
+CONF_TEMPERATURE_RESOLUTION = "temperature_resolution"
 CONF_INTERNAL_CURRENT_TEMPERATURE = "internal_current_temperature"
+CONF_CONTROL_SETTLE_TIME = "control_settle_time"
+CONF_INTENT_CONFIRM_CYCLES = "intent_confirm_cycles"
+CONF_INTENT_MAX_RETRIES = "intent_max_retries"
+CONF_BUS_TASK = "bus_task"
+CONF_CONFIRMATION_LATENCY = "confirmation_latency"
+CONF_ERROR_CODES = "error_codes"
+CONF_ON_ERROR = "on_error"
+CONF_ON_COMPRESSOR_START = "on_compressor_start"
+CONF_ON_COMPRESSOR_STOP = "on_compressor_stop"
+CONF_ON_DEFROST_START = "on_defrost_start"
+CONF_ON_DEFROST_END = "on_defrost_end"
+CONF_ON_UNIT_MODE_CHANGE = "on_unit_mode_change"
+CONF_ON_FRAME = "on_frame"
+CONF_SHORT_CYCLE_TIME = "short_cycle_time"
+CONF_COMPRESSOR_RUN_TIME = "compressor_run_time"
+CONF_COMPRESSOR_STARTS = "compressor_starts"
+CONF_DEFROST_COUNT = "defrost_count"
+CONF_SHORT_CYCLES = "short_cycles"
+CONF_LAST_CYCLE_DURATION = "last_cycle_duration"
+CONF_AVERAGE_CYCLE_DURATION = "average_cycle_duration"
+CONF_INDOOR_FAN_PWM = "indoor_fan_pwm"
+CONF_INDOOR_FAN_TACH = "indoor_fan_tach"
+CONF_COMPRESSOR_FLAGS = "compressor_flags"
+CONF_ESP_PROFILE = "esp_profile"
+CONF_PROTECTION_FLAGS = "protection_flags"
+CONF_DISCHARGE_TEMPERATURE = "discharge_temperature"
+CONF_EXPANSION_VALVE_POSITION = "expansion_valve_position"
+CONF_COMPRESSOR_FREQUENCY = "compressor_frequency"
+CONF_COMPRESSOR_RUNNING = "compressor_running"
+CONF_OUTDOOR_FAN_RUNNING = "outdoor_fan_running"
+CONF_COMPRESSOR_OK = "compressor_ok"
+CONF_OUTDOOR_FAN_OK = "outdoor_fan_ok"
+CONF_FOUR_WAY_VALVE_OK = "four_way_valve_ok"
+CONF_INVERTER_OK = "inverter_ok"
 midea_xye_ns = cg.esphome_ns.namespace("midea").namespace("xye")
 AirConditioner = midea_xye_ns.class_("AirConditioner", climate.Climate, cg.Component)
 StaticPressureNumber = midea_xye_ns.class_("StaticPressureNumber", number.Number, cg.Component)
 Capabilities = midea_xye_ns.namespace("Constants")
+TemperatureResolution = midea_xye_ns.enum("TemperatureResolution", is_class=True)
+ErrorTrigger = midea_xye_ns.class_("ErrorTrigger", automation.Trigger.template(cg.std_string))
+CompressorEventTrigger = midea_xye_ns.class_("CompressorEventTrigger", automation.Trigger.template())
+UnitModeChangeTrigger = midea_xye_ns.class_("UnitModeChangeTrigger", automation.Trigger.template(ClimateMode))
+ReceiveData = midea_xye_ns.class_("ReceiveData")
+ReceiveDataConstRef = ReceiveData.operator("ref").operator("const")
+FrameTrigger = midea_xye_ns.class_("FrameTrigger", automation.Trigger.template(ReceiveDataConstRef))
+CompressorEvent = midea_xye_ns.enum("CompressorEvent")
+COMPRESSOR_EVENT_TRIGGERS = {
+    CONF_ON_COMPRESSOR_START: CompressorEvent.COMPRESSOR_EVENT_START,
+    CONF_ON_COMPRESSOR_STOP: CompressorEvent.COMPRESSOR_EVENT_STOP,
+    CONF_ON_DEFROST_START: CompressorEvent.COMPRESSOR_EVENT_DEFROST_START,
+    CONF_ON_DEFROST_END: CompressorEvent.COMPRESSOR_EVENT_DEFROST_END,
+}
 
 def templatize(value):
     if isinstance(value, cv.Schema):
@@ -123,6 +186,12 @@ CUSTOM_PRESETS = {
     "FREEZE_PROTECTION": Capabilities.FREEZE_PROTECTION,
 }
 
+TEMPERATURE_RESOLUTIONS = {
+    "AUTO": TemperatureResolution.AUTO,
+    "WHOLE": TemperatureResolution.WHOLE,
+    "HALF": TemperatureResolution.HALF,
+}
+
 validate_modes = cv.enum(ALLOWED_CLIMATE_MODES, upper=True)
 validate_presets = cv.enum(ALLOWED_CLIMATE_PRESETS, upper=True)
 validate_swing_modes = cv.enum(ALLOWED_CLIMATE_SWING_MODES, upper=True)
@@ -135,7 +204,15 @@ CONFIG_SCHEMA = cv.All(
             cv.GenerateID(): cv.declare_id(AirConditioner),
             cv.Optional(CONF_PERIOD, default="1s"): cv.time_period,
             cv.Optional(CONF_TIMEOUT, default="100ms"): cv.time_period,
+            cv.Optional(CONF_CONTROL_SETTLE_TIME, default="500ms"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_INTENT_CONFIRM_CYCLES, default=3): cv.int_range(min=1, max=255),
+            cv.Optional(CONF_INTENT_MAX_RETRIES, default=1): cv.int_range(min=0, max=255),
+            # Dedicated FreeRTOS task for the bus I/O
+            cv.Optional(CONF_BUS_TASK): cv.All(cv.boolean, cv.only_on_esp32),
             cv.Optional(CONF_USE_FAHRENHEIT, default=False): cv.boolean,
+            cv.Optional(CONF_TEMPERATURE_RESOLUTION, default="WHOLE"): cv.enum(
+                TEMPERATURE_RESOLUTIONS, upper=True
+            ),
             cv.OnlyWith(CONF_TRANSMITTER_ID, "remote_transmitter"): cv.use_id(
                 remote_transmitter.RemoteTransmitterComponent
             ),
@@ -228,6 +305,15 @@ CONFIG_SCHEMA = cv.All(
                 device_class=DEVICE_CLASS_POWER,
                 state_class=STATE_CLASS_MEASUREMENT,
             ),
+            cv.Optional(CONF_ENERGY): sensor.sensor_schema(
+                unit_of_measurement=UNIT_KILOWATT_HOURS,
+                icon=ICON_POWER,
+                accuracy_decimals=3,
+                device_class=DEVICE_CLASS_ENERGY,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+            ),
+            # Real power meter used to calibrate the power estimate
+            cv.Optional(CONF_POWER_REFERENCE_SENSOR): cv.use_id(sensor.Sensor),
             cv.Optional(CONF_HUMIDITY_SETPOINT): sensor.sensor_schema(
                 unit_of_measurement=UNIT_PERCENT,
                 icon=ICON_WATER_PERCENT,
@@ -236,6 +322,7 @@ CONFIG_SCHEMA = cv.All(
                 state_class=STATE_CLASS_MEASUREMENT,
             ),
             cv.Optional(CONF_FOLLOW_ME_SENSOR): cv.use_id(sensor.Sensor),
+            cv.Optional(CONF_FOLLOW_ME_KEEPALIVE, default="30s"): cv.positive_time_period_milliseconds,
             cv.Optional(CONF_INTERNAL_CURRENT_TEMPERATURE): sensor.sensor_schema(
                 unit_of_measurement=UNIT_CELSIUS,
                 icon=ICON_THERMOMETER,
@@ -243,11 +330,188 @@ CONFIG_SCHEMA = cv.All(
                 device_class=DEVICE_CLASS_TEMPERATURE,
                 state_class=STATE_CLASS_MEASUREMENT,
             ),
+            cv.Optional(CONF_CONFIRMATION_LATENCY): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MILLISECOND,
+                icon=ICON_TIMER,
+                accuracy_decimals=0,
+                device_class=DEVICE_CLASS_DURATION,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ),
+            # Active E/P codes decoded from error_flags/protect_flags
+            cv.Optional(CONF_ERROR_CODES): text_sensor.text_sensor_schema(
+                icon=ICON_BUG,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_ON_ERROR): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(ErrorTrigger),
+                }
+            ),
+            # Hardware events, fired from the decode path
+            cv.Optional(CONF_ON_COMPRESSOR_START): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(CompressorEventTrigger),
+                }
+            ),
+            cv.Optional(CONF_ON_COMPRESSOR_STOP): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(CompressorEventTrigger),
+                }
+            ),
+            cv.Optional(CONF_ON_DEFROST_START): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(CompressorEventTrigger),
+                }
+            ),
+            cv.Optional(CONF_ON_DEFROST_END): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(CompressorEventTrigger),
+                }
+            ),
+            cv.Optional(CONF_ON_UNIT_MODE_CHANGE): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(UnitModeChangeTrigger),
+                }
+            ),
+            cv.Optional(CONF_ON_FRAME): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(FrameTrigger),
+                }
+            ),
+            # Compressor analytics, counters persisted across reboots
+            cv.Optional(CONF_SHORT_CYCLE_TIME, default="5min"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_COMPRESSOR_RUN_TIME): sensor.sensor_schema(
+                unit_of_measurement=UNIT_HOUR,
+                icon=ICON_TIMER,
+                accuracy_decimals=2,
+                device_class=DEVICE_CLASS_DURATION,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+            ),
+            cv.Optional(CONF_COMPRESSOR_STARTS): sensor.sensor_schema(
+                unit_of_measurement=UNIT_EMPTY,
+                icon=ICON_COUNTER,
+                accuracy_decimals=0,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+            ),
+            cv.Optional(CONF_DEFROST_COUNT): sensor.sensor_schema(
+                unit_of_measurement=UNIT_EMPTY,
+                icon=ICON_COUNTER,
+                accuracy_decimals=0,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+            ),
+            cv.Optional(CONF_SHORT_CYCLES): sensor.sensor_schema(
+                unit_of_measurement=UNIT_EMPTY,
+                icon=ICON_COUNTER,
+                accuracy_decimals=0,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+            ),
+            cv.Optional(CONF_LAST_CYCLE_DURATION): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MINUTE,
+                icon=ICON_TIMER,
+                accuracy_decimals=1,
+                device_class=DEVICE_CLASS_DURATION,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ),
+            cv.Optional(CONF_AVERAGE_CYCLE_DURATION): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MINUTE,
+                icon=ICON_TIMER,
+                accuracy_decimals=1,
+                device_class=DEVICE_CLASS_DURATION,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ),
+            # C4 engineering fields, raw as reported (0 = not exposed on some models)
+            cv.Optional(CONF_INDOOR_FAN_PWM): sensor.sensor_schema(
+                unit_of_measurement=UNIT_EMPTY,
+                icon=ICON_FAN,
+                accuracy_decimals=0,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ),
+            cv.Optional(CONF_INDOOR_FAN_TACH): sensor.sensor_schema(
+                unit_of_measurement=UNIT_EMPTY,
+                icon=ICON_FAN,
+                accuracy_decimals=0,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ),
+            cv.Optional(CONF_COMPRESSOR_FLAGS): sensor.sensor_schema(
+                unit_of_measurement=UNIT_EMPTY,
+                icon=ICON_SECURITY,
+                accuracy_decimals=0,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ),
+            cv.Optional(CONF_ESP_PROFILE): sensor.sensor_schema(
+                unit_of_measurement=UNIT_EMPTY,
+                icon=ICON_GAUGE,
+                accuracy_decimals=0,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ),
+            cv.Optional(CONF_PROTECTION_FLAGS): sensor.sensor_schema(
+                unit_of_measurement=UNIT_EMPTY,
+                icon=ICON_SECURITY,
+                accuracy_decimals=0,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ),
+            cv.Optional(CONF_DISCHARGE_TEMPERATURE): sensor.sensor_schema(
+                unit_of_measurement=UNIT_CELSIUS,
+                icon=ICON_THERMOMETER,
+                accuracy_decimals=1,
+                device_class=DEVICE_CLASS_TEMPERATURE,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ),
+            cv.Optional(CONF_EXPANSION_VALVE_POSITION): sensor.sensor_schema(
+                unit_of_measurement=UNIT_EMPTY,
+                icon=ICON_GAUGE,
+                accuracy_decimals=0,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ),
+            # Compressor Hz or outdoor fan RPM depending on the model
+            cv.Optional(CONF_COMPRESSOR_FREQUENCY): sensor.sensor_schema(
+                unit_of_measurement=UNIT_EMPTY,
+                icon=ICON_GAUGE,
+                accuracy_decimals=0,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                state_class=STATE_CLASS_MEASUREMENT,
+            ),
+            cv.Optional(CONF_COMPRESSOR_RUNNING): binary_sensor.binary_sensor_schema(
+                device_class=DEVICE_CLASS_RUNNING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_OUTDOOR_FAN_RUNNING): binary_sensor.binary_sensor_schema(
+                device_class=DEVICE_CLASS_RUNNING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_COMPRESSOR_OK): binary_sensor.binary_sensor_schema(
+                icon="mdi:check-circle-outline",
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_OUTDOOR_FAN_OK): binary_sensor.binary_sensor_schema(
+                icon="mdi:check-circle-outline",
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_FOUR_WAY_VALVE_OK): binary_sensor.binary_sensor_schema(
+                icon="mdi:check-circle-outline",
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_INVERTER_OK): binary_sensor.binary_sensor_schema(
+                icon="mdi:check-circle-outline",
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
         }
     )
     .extend(uart.UART_DEVICE_SCHEMA)
     .extend(cv.COMPONENT_SCHEMA),
-    cv.only_with_arduino,
 )
 
 # Actions
@@ -362,7 +626,14 @@ async def to_code(config):
     await climate.register_climate(var, config)
     cg.add(var.set_period(config[CONF_PERIOD].total_milliseconds))
     cg.add(var.set_response_timeout(config[CONF_TIMEOUT].total_milliseconds))
+    cg.add(var.set_control_settle_time(config[CONF_CONTROL_SETTLE_TIME].total_milliseconds))
+    cg.add(var.set_intent_confirm_cycles(config[CONF_INTENT_CONFIRM_CYCLES]))
+    cg.add(var.set_intent_max_retries(config[CONF_INTENT_MAX_RETRIES]))
+    if config.get(CONF_BUS_TASK, False):
+        cg.add(var.set_bus_task(True))
     cg.add(var.set_use_fahrenheit(config[CONF_USE_FAHRENHEIT]))
+    cg.add(var.set_temperature_resolution(config[CONF_TEMPERATURE_RESOLUTION]))
+    cg.add(var.set_follow_me_keepalive(config[CONF_FOLLOW_ME_KEEPALIVE].total_milliseconds))
     if CONF_TRANSMITTER_ID in config:
         cg.add_define("USE_REMOTE_TRANSMITTER")
         transmitter_ = await cg.get_variable(config[CONF_TRANSMITTER_ID])
@@ -415,6 +686,12 @@ async def to_code(config):
     if CONF_POWER_USAGE in config:
         sens = await sensor.new_sensor(config[CONF_POWER_USAGE])
         cg.add(var.set_power_sensor(sens))
+    if CONF_ENERGY in config:
+        sens = await sensor.new_sensor(config[CONF_ENERGY])
+        cg.add(var.set_energy_sensor(sens))
+    if CONF_POWER_REFERENCE_SENSOR in config:
+        sens = await cg.get_variable(config[CONF_POWER_REFERENCE_SENSOR])
+        cg.add(var.set_power_reference_sensor(sens))
     if CONF_HUMIDITY_SETPOINT in config:
         sens = await sensor.new_sensor(config[CONF_HUMIDITY_SETPOINT])
         cg.add(var.set_humidity_setpoint_sensor(sens))
@@ -424,3 +701,83 @@ async def to_code(config):
     if CONF_INTERNAL_CURRENT_TEMPERATURE in config:
         sens = await sensor.new_sensor(config[CONF_INTERNAL_CURRENT_TEMPERATURE])
         cg.add(var.set_internal_current_temperature_sensor(sens))
+    if CONF_CONFIRMATION_LATENCY in config:
+        sens = await sensor.new_sensor(config[CONF_CONFIRMATION_LATENCY])
+        cg.add(var.set_confirmation_latency_sensor(sens))
+    if CONF_ERROR_CODES in config:
+        sens = await text_sensor.new_text_sensor(config[CONF_ERROR_CODES])
+        cg.add(var.set_error_codes_text_sensor(sens))
+    for conf in config.get(CONF_ON_ERROR, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(trigger, [(cg.std_string, "code")], conf)
+    for key, event in COMPRESSOR_EVENT_TRIGGERS.items():
+        for conf in config.get(key, []):
+            trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var, event)
+            await automation.build_automation(trigger, [], conf)
+    for conf in config.get(CONF_ON_UNIT_MODE_CHANGE, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(trigger, [(ClimateMode, "mode")], conf)
+    for conf in config.get(CONF_ON_FRAME, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(trigger, [(ReceiveDataConstRef, "frame")], conf)
+    cg.add(var.set_short_cycle_time(config[CONF_SHORT_CYCLE_TIME].total_milliseconds))
+    if CONF_COMPRESSOR_RUN_TIME in config:
+        sens = await sensor.new_sensor(config[CONF_COMPRESSOR_RUN_TIME])
+        cg.add(var.set_compressor_run_time_sensor(sens))
+    if CONF_COMPRESSOR_STARTS in config:
+        sens = await sensor.new_sensor(config[CONF_COMPRESSOR_STARTS])
+        cg.add(var.set_compressor_starts_sensor(sens))
+    if CONF_DEFROST_COUNT in config:
+        sens = await sensor.new_sensor(config[CONF_DEFROST_COUNT])
+        cg.add(var.set_defrost_count_sensor(sens))
+    if CONF_SHORT_CYCLES in config:
+        sens = await sensor.new_sensor(config[CONF_SHORT_CYCLES])
+        cg.add(var.set_short_cycles_sensor(sens))
+    if CONF_LAST_CYCLE_DURATION in config:
+        sens = await sensor.new_sensor(config[CONF_LAST_CYCLE_DURATION])
+        cg.add(var.set_last_cycle_duration_sensor(sens))
+    if CONF_AVERAGE_CYCLE_DURATION in config:
+        sens = await sensor.new_sensor(config[CONF_AVERAGE_CYCLE_DURATION])
+        cg.add(var.set_average_cycle_duration_sensor(sens))
+    if CONF_INDOOR_FAN_PWM in config:
+        sens = await sensor.new_sensor(config[CONF_INDOOR_FAN_PWM])
+        cg.add(var.set_indoor_fan_pwm_sensor(sens))
+    if CONF_INDOOR_FAN_TACH in config:
+        sens = await sensor.new_sensor(config[CONF_INDOOR_FAN_TACH])
+        cg.add(var.set_indoor_fan_tach_sensor(sens))
+    if CONF_COMPRESSOR_FLAGS in config:
+        sens = await sensor.new_sensor(config[CONF_COMPRESSOR_FLAGS])
+        cg.add(var.set_compressor_flags_sensor(sens))
+    if CONF_ESP_PROFILE in config:
+        sens = await sensor.new_sensor(config[CONF_ESP_PROFILE])
+        cg.add(var.set_esp_profile_sensor(sens))
+    if CONF_PROTECTION_FLAGS in config:
+        sens = await sensor.new_sensor(config[CONF_PROTECTION_FLAGS])
+        cg.add(var.set_protection_flags_sensor(sens))
+    if CONF_DISCHARGE_TEMPERATURE in config:
+        sens = await sensor.new_sensor(config[CONF_DISCHARGE_TEMPERATURE])
+        cg.add(var.set_discharge_temperature_sensor(sens))
+    if CONF_EXPANSION_VALVE_POSITION in config:
+        sens = await sensor.new_sensor(config[CONF_EXPANSION_VALVE_POSITION])
+        cg.add(var.set_expansion_valve_position_sensor(sens))
+    if CONF_COMPRESSOR_FREQUENCY in config:
+        sens = await sensor.new_sensor(config[CONF_COMPRESSOR_FREQUENCY])
+        cg.add(var.set_compressor_frequency_sensor(sens))
+    if CONF_COMPRESSOR_RUNNING in config:
+        sens = await binary_sensor.new_binary_sensor(config[CONF_COMPRESSOR_RUNNING])
+        cg.add(var.set_compressor_running_binary_sensor(sens))
+    if CONF_OUTDOOR_FAN_RUNNING in config:
+        sens = await binary_sensor.new_binary_sensor(config[CONF_OUTDOOR_FAN_RUNNING])
+        cg.add(var.set_outdoor_fan_running_binary_sensor(sens))
+    if CONF_COMPRESSOR_OK in config:
+        sens = await binary_sensor.new_binary_sensor(config[CONF_COMPRESSOR_OK])
+        cg.add(var.set_compressor_ok_binary_sensor(sens))
+    if CONF_OUTDOOR_FAN_OK in config:
+        sens = await binary_sensor.new_binary_sensor(config[CONF_OUTDOOR_FAN_OK])
+        cg.add(var.set_outdoor_fan_ok_binary_sensor(sens))
+    if CONF_FOUR_WAY_VALVE_OK in config:
+        sens = await binary_sensor.new_binary_sensor(config[CONF_FOUR_WAY_VALVE_OK])
+        cg.add(var.set_four_way_valve_ok_binary_sensor(sens))
+    if CONF_INVERTER_OK in config:
+        sens = await binary_sensor.new_binary_sensor(config[CONF_INVERTER_OK])
+        cg.add(var.set_inverter_ok_binary_sensor(sens))
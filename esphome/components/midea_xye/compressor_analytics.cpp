@@ -0,0 +1,84 @@
+#include "compressor_analytics.h"
+
+namespace esphome {
+namespace midea {
+namespace xye {
+
+/// Run time between samples longer than this (bus outage) is not counted
+static constexpr uint32_t MAX_GAP_MS = 5 * 60 * 1000;
+
+uint8_t CompressorAnalytics::update(const CompressorSample &sample, uint32_t now) {
+  uint8_t events = COMPRESSOR_EVENT_NONE;
+
+  if (!this->seen_) {
+    // The first snapshot only establishes the state; a unit already running is not a start
+    this->seen_ = true;
+    this->running_ = sample.compressor_on;
+    this->started_at_ = now;
+    this->sampled_at_ = now;
+    return events;
+  }
+
+  if (this->running_) {
+    const uint32_t dt = now - this->sampled_at_;
+    if (dt <= MAX_GAP_MS) {
+      this->run_ms_ += dt;
+      this->counters_.run_seconds += this->run_ms_ / 1000;
+      this->run_ms_ %= 1000;
+    }
+  }
+  this->sampled_at_ = now;
+
+  if (sample.compressor_on && !this->running_) {
+    this->running_ = true;
+    this->started_at_ = now;
+    this->counters_.starts++;
+    events |= COMPRESSOR_EVENT_START;
+  } else if (!sample.compressor_on && this->running_) {
+    this->running_ = false;
+    const uint32_t duration = now - this->started_at_;
+    this->push_cycle_(duration);
+    events |= COMPRESSOR_EVENT_STOP;
+    if (duration < this->short_cycle_ms_) {
+      this->counters_.short_cycles++;
+      events |= COMPRESSOR_EVENT_SHORT_CYCLE;
+    }
+  }
+
+  const bool defrosting = sample.heating && sample.compressor_on && !sample.outdoor_fan_on && !sample.indoor_fan_on;
+  if (defrosting && !this->defrosting_) {
+    this->counters_.defrosts++;
+    events |= COMPRESSOR_EVENT_DEFROST_START;
+  } else if (!defrosting && this->defrosting_) {
+    events |= COMPRESSOR_EVENT_DEFROST_END;
+  }
+  this->defrosting_ = defrosting;
+
+  return events;
+}
+
+void CompressorAnalytics::push_cycle_(uint32_t duration) {
+  this->ring_[this->ring_pos_] = duration;
+  this->ring_pos_ = (this->ring_pos_ + 1) % RING_SIZE;
+  if (this->ring_fill_ < RING_SIZE)
+    this->ring_fill_++;
+}
+
+uint32_t CompressorAnalytics::cycle_ms(uint8_t age) const {
+  if (age >= this->ring_fill_)
+    return 0;
+  return this->ring_[(this->ring_pos_ + RING_SIZE - 1 - age) % RING_SIZE];
+}
+
+uint32_t CompressorAnalytics::average_cycle_ms() const {
+  if (this->ring_fill_ == 0)
+    return 0;
+  uint64_t sum = 0;
+  for (uint8_t i = 0; i < this->ring_fill_; i++)
+    sum += this->ring_[i];
+  return static_cast<uint32_t>(sum / this->ring_fill_);
+}
+
+}  // namespace xye
+}  // namespace midea
+}  // namespace esphome
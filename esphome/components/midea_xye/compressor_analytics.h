@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace midea {
+namespace xye {
+
+/**
+ * @brief Compressor-related state decoded from one C0/C4 snapshot pair
+ */
+struct CompressorSample {
+  bool compressor_on{false};   ///< C4 CompressorFlags bit 7
+  bool outdoor_fan_on{false};  ///< C4 ProtectionFlags bit 7
+  bool indoor_fan_on{false};   ///< C0 fan bits non-zero
+  bool heating{false};         ///< Mode is HEAT
+};
+
+/**
+ * @brief Maintenance counters, persisted across reboots
+ */
+struct CompressorCounters {
+  uint32_t run_seconds{0};
+  uint32_t starts{0};
+  uint32_t defrosts{0};
+  uint32_t short_cycles{0};
+} __attribute__((packed));
+
+/**
+ * @brief Events raised by CompressorAnalytics::update(), as a bitmask
+ */
+enum CompressorEvent : uint8_t {
+  COMPRESSOR_EVENT_NONE = 0,
+  COMPRESSOR_EVENT_START = 1 << 0,
+  COMPRESSOR_EVENT_STOP = 1 << 1,
+  COMPRESSOR_EVENT_DEFROST_START = 1 << 2,
+  COMPRESSOR_EVENT_DEFROST_END = 1 << 3,
+  COMPRESSOR_EVENT_SHORT_CYCLE = 1 << 4,
+};
+
+/**
+ * @brief Compressor run hours, starts, defrosts and short cycles from the snapshot stream
+ *
+ * Fed once per decoded snapshot. Counters are O(1) running totals; the durations of
+ * the last RING_SIZE completed on-cycles are kept for cycle statistics. Defrost has
+ * no dedicated flag, so it is inferred the way the unit behaves while defrosting:
+ * heating, compressor running, outdoor and indoor fans stopped.
+ */
+class CompressorAnalytics {
+ public:
+  static constexpr uint8_t RING_SIZE = 8;
+
+  /// On-cycles shorter than this count as short cycles
+  void set_short_cycle_threshold(uint32_t ms) { this->short_cycle_ms_ = ms; }
+
+  /// Returns the CompressorEvent bits raised by this sample
+  uint8_t update(const CompressorSample &sample, uint32_t now);
+
+  const CompressorCounters &counters() const { return this->counters_; }
+  void restore(const CompressorCounters &counters) { this->counters_ = counters; }
+
+  bool running() const { return this->running_; }
+  bool defrosting() const { return this->defrosting_; }
+  /// Completed cycles held in the ring (at most RING_SIZE)
+  uint8_t cycle_count() const { return this->ring_fill_; }
+  /// Duration of a completed on-cycle, 0 = most recent
+  uint32_t cycle_ms(uint8_t age) const;
+  /// Mean of the cycles held in the ring, 0 when none
+  uint32_t average_cycle_ms() const;
+
+ protected:
+  void push_cycle_(uint32_t duration);
+
+  uint32_t short_cycle_ms_{5 * 60 * 1000};
+
+  CompressorCounters counters_;
+  bool seen_{false};
+  bool running_{false};
+  bool defrosting_{false};
+  uint32_t started_at_{0};
+  uint32_t sampled_at_{0};
+  uint32_t run_ms_{0};  ///< Run time not yet rolled into run_seconds
+
+  uint32_t ring_[RING_SIZE]{};
+  uint8_t ring_pos_{0};
+  uint8_t ring_fill_{0};
+};
+
+}  // namespace xye
+}  // namespace midea
+}  // namespace esphome
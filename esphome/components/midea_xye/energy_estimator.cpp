@@ -0,0 +1,113 @@
+#include "energy_estimator.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace midea {
+namespace xye {
+
+/// Standby draw, W per 100 Hz, W at full fan, W per 10 A, extra W per 100 Hz when heating.
+/// Compressor and current each carry half of a ~20 W/Hz, 230 V unit until calibrated.
+static constexpr float PRIOR[EnergyEstimator::FEATURES] = {5.0f, 1000.0f, 30.0f, 1150.0f, 0.0f};
+/// Initial covariance: how far (W) the prior may be off
+static constexpr float PRIOR_VARIANCE = 1.0e4f;
+/// Covariance trace cap, keeps the gain bounded during long steady-state stretches
+static constexpr float MAX_TRACE = 1.0e5f * EnergyEstimator::FEATURES;
+static constexpr float FORGETTING = 0.995f;
+static constexpr double MS_PER_HOUR = 3600.0 * 1000.0;
+
+void EnergyEstimator::features_(const PowerInputs &in, float *x) {
+  // NaN fails both comparisons, so a missing value drops out as well
+  const bool hz_valid = in.compressor_hz >= 0.0f && in.compressor_hz <= MAX_COMPRESSOR_HZ;
+  const float hz = in.running && hz_valid ? in.compressor_hz / 100.0f : 0.0f;
+  x[0] = 1.0f;
+  x[1] = hz;
+  x[2] = in.running ? in.fan_duty : 0.0f;
+  x[3] = in.running && !std::isnan(in.current_a) ? in.current_a / 10.0f : 0.0f;
+  x[4] = in.heating ? hz : 0.0f;
+}
+
+void EnergyEstimator::reset_calibration() {
+  for (uint8_t i = 0; i < FEATURES; i++) {
+    this->theta_[i] = PRIOR[i];
+    for (uint8_t j = 0; j < FEATURES; j++)
+      this->p_[i][j] = i == j ? PRIOR_VARIANCE : 0.0f;
+  }
+  this->samples_ = 0;
+}
+
+void EnergyEstimator::set_coefficients(const float *theta) {
+  for (uint8_t i = 0; i < FEATURES; i++) {
+    if (!std::isfinite(theta[i]))
+      return;
+  }
+  for (uint8_t i = 0; i < FEATURES; i++)
+    this->theta_[i] = theta[i];
+}
+
+float EnergyEstimator::estimate(const PowerInputs &in) const {
+  float x[FEATURES];
+  features_(in, x);
+  float watts = 0.0f;
+  for (uint8_t i = 0; i < FEATURES; i++)
+    watts += this->theta_[i] * x[i];
+  return watts > 0.0f ? watts : 0.0f;
+}
+
+void EnergyEstimator::calibrate(const PowerInputs &in, float measured_w) {
+  if (!std::isfinite(measured_w) || measured_w < 0.0f)
+    return;
+
+  float x[FEATURES];
+  features_(in, x);
+
+  // px = P x, gain = P x / (lambda + x' P x)
+  float px[FEATURES];
+  float denom = FORGETTING;
+  for (uint8_t i = 0; i < FEATURES; i++) {
+    px[i] = 0.0f;
+    for (uint8_t j = 0; j < FEATURES; j++)
+      px[i] += this->p_[i][j] * x[j];
+    denom += x[i] * px[i];
+  }
+
+  float predicted = 0.0f;
+  for (uint8_t i = 0; i < FEATURES; i++)
+    predicted += this->theta_[i] * x[i];
+  const float error = measured_w - predicted;
+  for (uint8_t i = 0; i < FEATURES; i++)
+    this->theta_[i] += px[i] / denom * error;
+
+  // P = (P - px px' / denom) / lambda, kept symmetric and bounded
+  float trace = 0.0f;
+  for (uint8_t i = 0; i < FEATURES; i++) {
+    for (uint8_t j = i; j < FEATURES; j++) {
+      const float v = (this->p_[i][j] - px[i] * px[j] / denom) / FORGETTING;
+      this->p_[i][j] = v;
+      this->p_[j][i] = v;
+    }
+    trace += this->p_[i][i];
+  }
+  if (trace > MAX_TRACE) {
+    const float scale = MAX_TRACE / trace;
+    for (auto &row : this->p_) {
+      for (auto &v : row)
+        v *= scale;
+    }
+  }
+  this->samples_++;
+}
+
+void EnergyEstimator::integrate(float watts, uint32_t now) {
+  if (this->integrating_) {
+    const uint32_t dt = now - this->integrated_at_;
+    if (dt <= MAX_GAP_MS && std::isfinite(watts))
+      this->energy_kwh_ += watts * (dt / MS_PER_HOUR) / 1000.0;
+  }
+  this->integrating_ = true;
+  this->integrated_at_ = now;
+}
+
+}  // namespace xye
+}  // namespace midea
+}  // namespace esphome
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace midea {
+namespace xye {
+
+/**
+ * @brief Operating point of the unit, as decoded from the latest C0/C4 snapshots
+ */
+struct PowerInputs {
+  float compressor_hz{0.0f};  ///< C4 bytes 13-14 (compressor Hz or outdoor fan RPM)
+  float fan_duty{0.0f};       ///< C4 indoor fan PWM scaled to 0..1
+  float current_a{NAN};       ///< C0 current byte, NaN when the unit does not report it (0xFF)
+  bool running{false};        ///< Mode is not OFF
+  bool heating{false};        ///< Mode is HEAT
+};
+
+/**
+ * @brief Linear power model calibrated online, with kWh integration
+ *
+ * Power is modelled as theta . x with x = [1, Hz/100, fan, A/10, heating * Hz/100],
+ * starting from a prior that splits the estimate between the compressor frequency
+ * and the current byte. When a reference power meter is available every reading
+ * refines theta by recursive least squares (forgetting factor 0.995), so the
+ * model follows the installation instead of a datasheet.
+ *
+ * Inputs the unit does not report sensibly contribute nothing: a missing current
+ * byte, and a compressor value above MAX_COMPRESSOR_HZ (outdoor fan RPM on some
+ * units, or the 0xBCD6 marker). Calibration then only moves the other coefficients.
+ */
+class EnergyEstimator {
+ public:
+  static constexpr uint8_t FEATURES = 5;
+  /// Integration gaps longer than this (bus outage, reboot) are not extrapolated
+  static constexpr uint32_t MAX_GAP_MS = 5 * 60 * 1000;
+  /// Above this the C4 value is not a compressor frequency
+  static constexpr float MAX_COMPRESSOR_HZ = 150.0f;
+
+  EnergyEstimator() { this->reset_calibration(); }
+
+  /// Instantaneous power in W, never negative
+  float estimate(const PowerInputs &in) const;
+
+  /// Refine the model with a reference reading taken at this operating point
+  void calibrate(const PowerInputs &in, float measured_w);
+
+  /// Accumulate 'watts' since the previous call
+  void integrate(float watts, uint32_t now);
+
+  double energy_kwh() const { return this->energy_kwh_; }
+  void set_energy_kwh(double kwh) { this->energy_kwh_ = kwh; }
+
+  const float *coefficients() const { return this->theta_; }
+  void set_coefficients(const float *theta);
+  uint32_t calibration_samples() const { return this->samples_; }
+  void reset_calibration();
+
+ protected:
+  static void features_(const PowerInputs &in, float *x);
+
+  float theta_[FEATURES];
+  float p_[FEATURES][FEATURES];
+  uint32_t samples_{0};
+
+  double energy_kwh_{0.0};
+  uint32_t integrated_at_{0};
+  bool integrating_{false};
+};
+
+}  // namespace xye
+}  // namespace midea
+}  // namespace esphome
@@ -0,0 +1,114 @@
+#include "fault_decoder.h"
+
+#include <cstdio>
+
+namespace esphome {
+namespace midea {
+namespace xye {
+
+static const FaultCode FAULT_CODES[FaultDecoder::BITS] = {
+    // Error word, C0 bytes 22-23
+    {"E0", "Indoor EEPROM error"},
+    {"E1", "Indoor/outdoor communication error"},
+    {"E2", "Zero-crossing detection error"},
+    {"E3", "Indoor fan speed out of control"},
+    {"E4", "Room temperature sensor (T1) fault"},
+    {"E5", "Indoor coil temperature sensor (T2) fault"},
+    {"E6", "Outdoor coil temperature sensor (T3) fault"},
+    {"E7", "Outdoor EEPROM error"},
+    {"E8", "Outdoor fan speed out of control"},
+    {"E9", "Wired controller communication error"},
+    {"EA", "Outdoor current detection error"},
+    {"EB", "Inverter module communication error"},
+    {"EC", "Refrigerant leak detected"},
+    {"ED", "Outdoor unit fault"},
+    {"EE", "Water level alarm"},
+    {"EF", "Other indoor fault"},
+    // Protection word, C0 bytes 24-25
+    {"P0", "IPM module protection"},
+    {"P1", "Over/under voltage protection"},
+    {"P2", "Compressor top temperature protection"},
+    {"P3", "Outdoor low temperature protection"},
+    {"P4", "Compressor drive error"},
+    {"P5", "High pressure protection"},
+    {"P6", "Low pressure protection"},
+    {"P7", "Outdoor IPM temperature protection"},
+    {"P8", "Over-current protection"},
+    {"P9", "Discharge temperature protection"},
+    {"PA", "Evaporator anti-freeze protection"},
+    {"PB", "Evaporator high temperature protection"},
+    {"PC", "Condenser high temperature protection"},
+    {"PD", "Outdoor fan protection"},
+    {"PE", "4-way valve reversing error"},
+    {"PF", "Other protection"},
+};
+
+const FaultCode &FaultDecoder::code(uint8_t index) { return FAULT_CODES[index % BITS]; }
+
+uint32_t FaultDecoder::update(uint16_t errors, uint16_t protections, uint32_t epoch, uint32_t uptime_s) {
+  const uint32_t current = static_cast<uint32_t>(errors) | (static_cast<uint32_t>(protections) << 16);
+  // Faults already present at the first snapshot are new to us as well
+  const uint32_t previous = this->seen_ ? this->active_ : 0;
+  this->seen_ = true;
+  const uint32_t changed = previous ^ current;
+  if (changed == 0)
+    return 0;
+
+  this->active_ = current;
+  for (uint8_t i = 0; i < BITS; i++) {
+    if (changed & (1UL << i))
+      this->record_(i, current & (1UL << i), epoch, uptime_s);
+  }
+  return changed & current;
+}
+
+void FaultDecoder::record_(uint8_t index, bool active, uint32_t epoch, uint32_t uptime_s) {
+  const FaultEvent event{epoch, uptime_s, index, static_cast<uint8_t>(active ? 1 : 0)};
+  this->ring_[this->ring_pos_] = event;
+  this->ring_pos_ = (this->ring_pos_ + 1) % RING_SIZE;
+  if (this->ring_fill_ < RING_SIZE)
+    this->ring_fill_++;
+
+  if (!active)
+    return;
+  // Flash history keeps only new faults, newest first
+  auto &h = this->history_;
+  for (uint8_t i = FaultHistory::SIZE - 1; i > 0; i--)
+    h.events[i] = h.events[i - 1];
+  h.events[0] = event;
+  if (h.count < FaultHistory::SIZE)
+    h.count++;
+}
+
+const FaultEvent &FaultDecoder::event(uint8_t age) const {
+  const uint8_t clamped = age < this->ring_fill_ ? age : 0;
+  return this->ring_[(this->ring_pos_ + RING_SIZE - 1 - clamped) % RING_SIZE];
+}
+
+void FaultDecoder::restore(const FaultHistory &history) {
+  this->history_ = history;
+  if (this->history_.count > FaultHistory::SIZE)
+    this->history_.count = FaultHistory::SIZE;
+}
+
+size_t FaultDecoder::format_active(char *buffer, size_t size) const {
+  if (size == 0)
+    return 0;
+  if (this->active_ == 0)
+    return snprintf(buffer, size, "None");
+  size_t len = 0;
+  buffer[0] = '\0';
+  for (uint8_t i = 0; i < BITS && len + 1 < size; i++) {
+    if (this->active_ & (1UL << i)) {
+      const int written = snprintf(buffer + len, size - len, len == 0 ? "%s" : " %s", FAULT_CODES[i].code);
+      if (written < 0)
+        break;
+      len += written;
+    }
+  }
+  return len < size ? len : size - 1;
+}
+
+}  // namespace xye
+}  // namespace midea
+}  // namespace esphome
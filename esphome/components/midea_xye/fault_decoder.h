@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace midea {
+namespace xye {
+
+/**
+ * @brief Display code and description of one error/protection bit
+ */
+struct FaultCode {
+  const char *code;
+  const char *description;
+};
+
+/**
+ * @brief One set or clear transition of a fault bit
+ */
+struct FaultEvent {
+  uint32_t epoch;      ///< Wall-clock seconds, 0 when the clock was not set
+  uint32_t uptime_s;   ///< Seconds since boot
+  uint8_t index;       ///< 0-15 error bits, 16-31 protection bits
+  uint8_t active;      ///< 1 = set, 0 = cleared
+} __attribute__((packed));
+
+/**
+ * @brief Last faults kept in flash
+ */
+struct FaultHistory {
+  static constexpr uint8_t SIZE = 4;
+  FaultEvent events[SIZE];
+  uint8_t count;
+} __attribute__((packed));
+
+/**
+ * @brief Decodes the C0 error and protection words into Midea E/P codes
+ *
+ * Bit n of the error word is reported as En, bit n of the protection word as Pn
+ * (n in hex), following the common Midea numbering; individual models may differ,
+ * see the service manual. Transitions are found with one XOR of the previous and
+ * current words, so an unchanged snapshot costs nothing. Every transition is
+ * recorded in a RAM ring of RING_SIZE events; new faults are also copied into a
+ * FaultHistory meant for flash.
+ */
+class FaultDecoder {
+ public:
+  static constexpr uint8_t RING_SIZE = 16;
+  static constexpr uint8_t BITS = 32;
+
+  static const FaultCode &code(uint8_t index);
+
+  /**
+   * @brief Feed the current words
+   * @return Bits (error in 0-15, protection in 16-31) that became active with this snapshot
+   */
+  uint32_t update(uint16_t errors, uint16_t protections, uint32_t epoch, uint32_t uptime_s);
+
+  uint32_t active() const { return this->active_; }
+
+  /// Space-separated active codes ("E1 P4"), or "None"; returns the length written
+  size_t format_active(char *buffer, size_t size) const;
+
+  uint8_t event_count() const { return this->ring_fill_; }
+  /// Recorded transition, 0 = most recent
+  const FaultEvent &event(uint8_t age) const;
+
+  const FaultHistory &history() const { return this->history_; }
+  void restore(const FaultHistory &history);
+
+ protected:
+  void record_(uint8_t index, bool active, uint32_t epoch, uint32_t uptime_s);
+
+  uint32_t active_{0};
+  bool seen_{false};
+
+  FaultEvent ring_[RING_SIZE]{};
+  uint8_t ring_pos_{0};
+  uint8_t ring_fill_{0};
+
+  FaultHistory history_{};
+};
+
+}  // namespace xye
+}  // namespace midea
+}  // namespace esphome
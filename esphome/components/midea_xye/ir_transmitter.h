@@ -1,6 +1,5 @@
 #pragma once
 
-#ifdef USE_ARDUINO
 #ifdef USE_REMOTE_TRANSMITTER
 #include "esphome/components/remote_base/midea_protocol.h"
 
@@ -57,4 +56,3 @@ class IrTransmitter {
 }  // namespace esphome
 
 #endif
-#endif  // USE_ARDUINO
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace midea {
+namespace xye {
+
+/**
+ * @brief Outcome of reconciling a reported value against a pending intent
+ */
+enum class IntentResult : uint8_t {
+  NONE = 0,       ///< No intent pending - reported value is authoritative
+  PENDING = 1,    ///< Intent not yet confirmed - keep the optimistic value
+  CONFIRMED = 2,  ///< Reported value matches the intent
+  RESEND = 3,     ///< Not confirmed within the allowed cycles - send SET again
+  ROLLBACK = 4    ///< Retries exhausted - adopt the reported value
+};
+
+/// Values compare equal when the unit would report them identically.
+template<typename T> inline bool intent_matches(const T &wanted, const T &reported) { return wanted == reported; }
+
+/// Target temperature is reported in whole degrees, so allow for truncation on the way out.
+template<> inline bool intent_matches<float>(const float &wanted, const float &reported) {
+  return std::fabs(wanted - reported) < 1.0f;
+}
+
+/**
+ * @brief A value requested from the unit that has not been confirmed yet
+ *
+ * Armed when the user changes a field, stamped when the SET carrying it goes out
+ * on the bus, and checked against every following status snapshot. The snapshot
+ * is only allowed to overwrite the optimistic value once the intent is confirmed
+ * or given up on, so a stale response cannot bounce the frontend back and forth.
+ */
+template<typename T> struct PendingIntent {
+  T value{};
+  bool active{false};
+  uint32_t sent_at{0};  ///< millis() of the first SET carrying the value (0 = not sent yet)
+  uint8_t cycles{0};    ///< Snapshots seen since the last SET without a match
+  uint8_t retries{0};   ///< SETs re-sent for this intent
+
+  void arm(const T &wanted) {
+    this->value = wanted;
+    this->active = true;
+    this->sent_at = 0;
+    this->cycles = 0;
+    this->retries = 0;
+  }
+
+  /// Give up on the intent without waiting for the unit, e.g. when it can no longer be confirmed
+  void cancel() { this->active = false; }
+
+  void mark_sent(uint32_t now) {
+    if (this->active && this->sent_at == 0)
+      this->sent_at = now;
+  }
+
+  /**
+   * @brief Reconcile a reported value against this intent
+   * @param reported Value decoded from the status snapshot
+   * @param max_cycles Snapshots to wait for confirmation before acting
+   * @param max_retries SETs to re-send before rolling back
+   */
+  IntentResult reconcile(const T &reported, uint8_t max_cycles, uint8_t max_retries) {
+    if (!this->active)
+      return IntentResult::NONE;
+    if (intent_matches(this->value, reported)) {
+      this->active = false;
+      return IntentResult::CONFIRMED;
+    }
+    // Still sitting in the settle window - the unit has not seen the request yet.
+    if (this->sent_at == 0)
+      return IntentResult::PENDING;
+    if (++this->cycles < max_cycles)
+      return IntentResult::PENDING;
+    if (this->retries < max_retries) {
+      this->retries++;
+      this->cycles = 0;
+      return IntentResult::RESEND;
+    }
+    this->active = false;
+    return IntentResult::ROLLBACK;
+  }
+};
+
+}  // namespace xye
+}  // namespace midea
+}  // namespace esphome
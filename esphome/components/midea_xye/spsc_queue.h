@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace midea {
+namespace xye {
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring buffer
+ *
+ * One thread may push() and one other thread may pop(); neither blocks. The head
+ * is only written by the consumer and the tail only by the producer, so a pair of
+ * acquire/release atomics is all the synchronisation needed. One slot is kept free
+ * to tell a full ring from an empty one, so at most SIZE - 1 items are queued.
+ */
+template<typename T, size_t SIZE> class SpscQueue {
+  static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "SIZE must be a power of two");
+
+ public:
+  /// Producer side; false when the ring is full
+  bool push(const T &item) {
+    const size_t tail = this->tail_.load(std::memory_order_relaxed);
+    const size_t next = (tail + 1) & (SIZE - 1);
+    if (next == this->head_.load(std::memory_order_acquire))
+      return false;
+    this->items_[tail] = item;
+    this->tail_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  /// Consumer side; false when the ring is empty
+  bool pop(T &item) {
+    const size_t head = this->head_.load(std::memory_order_relaxed);
+    if (head == this->tail_.load(std::memory_order_acquire))
+      return false;
+    item = this->items_[head];
+    this->head_.store((head + 1) & (SIZE - 1), std::memory_order_release);
+    return true;
+  }
+
+  /// Consumer side
+  bool empty() const {
+    return this->head_.load(std::memory_order_relaxed) == this->tail_.load(std::memory_order_acquire);
+  }
+
+ protected:
+  T items_[SIZE];
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+};
+
+}  // namespace xye
+}  // namespace midea
+}  // namespace esphome
@@ -1,5 +1,3 @@
-#ifdef USE_ARDUINO
-
 #include "xye.h"
 #include "esphome/core/log.h"
 
@@ -171,5 +169,3 @@ const std::map<SubsystemFlags, const char*> SUBSYSTEM_FLAGS_MAP = {
 }  // namespace xye
 }  // namespace midea
 }  // namespace esphome
-
-#endif  // USE_ARDUINO
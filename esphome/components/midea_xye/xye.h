@@ -1,7 +1,5 @@
 #pragma once
 
-#ifdef USE_ARDUINO
-
 #include <cstdint>
 #include <map>
 #include "esphome/core/log.h"
@@ -470,5 +468,3 @@ static_assert(sizeof(MessageFrameEnd) == 2, "MessageFrameEnd must be 2 bytes (CR
 }  // namespace xye
 }  // namespace midea
 }  // namespace esphome
-
-#endif  // USE_ARDUINO
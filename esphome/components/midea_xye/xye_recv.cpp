@@ -1,5 +1,3 @@
-#ifdef USE_ARDUINO
-
 #include "xye_recv.h"
 #include "xye_log.h"
 
@@ -129,5 +127,3 @@ size_t ReceiveData::print_debug(size_t left, const char *tag, int level) const {
 }  // namespace xye
 }  // namespace midea
 }  // namespace esphome
-
-#endif  // USE_ARDUINO
@@ -1,7 +1,5 @@
 #pragma once
 
-#ifdef USE_ARDUINO
-
 #include "xye.h"
 
 namespace esphome {
@@ -217,5 +215,3 @@ static_assert(sizeof(ReceiveData) == RX_MESSAGE_LENGTH, "ReceiveData size must m
 }  // namespace xye
 }  // namespace midea
 }  // namespace esphome
-
-#endif  // USE_ARDUINO
@@ -1,5 +1,3 @@
-#ifdef USE_ARDUINO
-
 #include "xye_send.h"
 #include "xye_log.h"
 
@@ -49,5 +47,3 @@ size_t TransmitData::print_debug(const char *tag, size_t left, int level) const
 }  // namespace xye
 }  // namespace midea
 }  // namespace esphome
-
-#endif  // USE_ARDUINO
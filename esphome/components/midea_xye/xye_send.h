@@ -1,7 +1,5 @@
 #pragma once
 
-#ifdef USE_ARDUINO
-
 #include "xye.h"
 
 namespace esphome {
@@ -95,5 +93,3 @@ static_assert(sizeof(TransmitData) == TX_MESSAGE_LENGTH, "TransmitData size must
 }  // namespace xye
 }  // namespace midea
 }  // namespace esphome
-
-#endif  // USE_ARDUINO
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "esphome/core/automation.h"
+#include "virtual_thermostat.h"
+
+namespace esphome {
+namespace virtual_thermostat {
+
+template<typename... Ts> class SchedulePresetAction : public Action<Ts...> {
+ public:
+  void set_parent(VirtualThermostat *parent) { this->parent_ = parent; }
+
+  TEMPLATABLE_VALUE(climate::ClimatePreset, preset)
+  TEMPLATABLE_VALUE(uint32_t, delay)
+
+  void play(const Ts &...x) override {
+    this->parent_->schedule_preset(this->preset_.value(x...), this->delay_.value(x...));
+  }
+
+ protected:
+  VirtualThermostat *parent_;
+};
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
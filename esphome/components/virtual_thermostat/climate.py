@@ -1,23 +1,212 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.components import climate, sensor, number
-from esphome.const import CONF_ID
+from esphome import automation
+from esphome.components import binary_sensor, climate, sensor, number, text_sensor, time
+from esphome.const import (
+    CONF_DAYS_OF_WEEK,
+    CONF_DELAY,
+    CONF_HOUR,
+    CONF_ID,
+    CONF_MAX,
+    CONF_MIN,
+    CONF_MINUTE,
+    CONF_NAME,
+    CONF_PRESET,
+    CONF_SENSOR,
+    CONF_TIME,
+    CONF_TIME_ID,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+)
 import esphome.core as core
 
+AUTO_LOAD = ["text_sensor"]
+
 CONF_INSIDE_SENSOR = "inside_sensor"
 CONF_OUTSIDE_SENSOR = "outside_sensor"
-CONF_REAL_CLIMATE = "real_climate"
-CONF_UPDATE_INTERVAL = "update_interval"
-
 CONF_HOME_MIN = "home_min"
 CONF_HOME_MAX = "home_max"
 CONF_SLEEP_MIN = "sleep_min"
 CONF_SLEEP_MAX = "sleep_max"
 CONF_AWAY_MIN = "away_min"
 CONF_AWAY_MAX = "away_max"
+CONF_REAL_CLIMATE = "real_climate"
+CONF_UPDATE_INTERVAL = "update_interval"
+CONF_MODE_HYSTERESIS = "mode_hysteresis"
+CONF_MIN_MODE_DWELL = "min_mode_dwell"
+CONF_MAX_MODE_CHANGES_PER_HOUR = "max_mode_changes_per_hour"
+CONF_MAX_PREHEAT_TIME = "max_preheat_time"
+CONF_PRESETS = "presets"
+CONF_ZONES = "zones"
+CONF_ZONE_AGGREGATION = "zone_aggregation"
+CONF_WEIGHT = "weight"
+CONF_OCCUPANCY = "occupancy"
+CONF_ADDITIONAL_REAL_CLIMATES = "additional_real_climates"
+CONF_T1_SENSOR = "t1_sensor"
+CONF_INSIDE_STALE_TIMEOUT = "inside_stale_timeout"
+CONF_SETPOINT_STEP = "setpoint_step"
+CONF_TRIM_KP = "trim_kp"
+CONF_TRIM_KI = "trim_ki"
+CONF_MAX_SETPOINT_TRIM = "max_setpoint_trim"
+CONF_MIN_SETPOINT_INTERVAL = "min_setpoint_interval"
+CONF_OUTSIDE_STALE_TIMEOUT = "outside_stale_timeout"
+CONF_FAILSAFE_MODE = "failsafe_mode"
+CONF_FAILSAFE_TEMPERATURE = "failsafe_temperature"
+CONF_FAILSAFE_STATE = "failsafe_state"
+CONF_OUTDOOR_RESET = "outdoor_reset"
+CONF_HEAT = "heat"
+CONF_COOL = "cool"
+CONF_OUTSIDE = "outside"
+CONF_OFFSET = "offset"
+
+# Must match OutdoorResetCurve::MAX_POINTS
+OUTDOOR_RESET_MAX_POINTS = 8
+CONF_SCHEDULE = "schedule"
+CONF_SCHEDULE_TABLE_ID = "schedule_table_id"
+
+# Bit positions match ESPTime::day_of_week - 1
+DAYS_OF_WEEK = {"SUN": 0, "MON": 1, "TUE": 2, "WED": 3, "THU": 4, "FRI": 5, "SAT": 6}
+# Values of esphome::climate::ClimatePreset, packed into the schedule table
+PRESETS = {
+    "NONE": 0,
+    "HOME": 1,
+    "AWAY": 2,
+    "BOOST": 3,
+    "COMFORT": 4,
+    "ECO": 5,
+    "SLEEP": 6,
+    "ACTIVITY": 7,
+}
+
+SCHEDULE_ENTRY_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_DAYS_OF_WEEK, default=list(DAYS_OF_WEEK)): cv.ensure_list(
+            cv.one_of(*DAYS_OF_WEEK, upper=True)
+        ),
+        cv.Required(CONF_TIME): cv.time_of_day,
+        cv.Required(CONF_PRESET): cv.one_of(*PRESETS, upper=True),
+    }
+)
+
+
+RESET_POINT_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_OUTSIDE): cv.temperature,
+        cv.Required(CONF_OFFSET): cv.temperature_delta,
+    }
+)
+
+
+def validate_reset_curve(points):
+    points = sorted(points, key=lambda p: p[CONF_OUTSIDE])
+    outsides = [p[CONF_OUTSIDE] for p in points]
+    if len(set(outsides)) != len(outsides):
+        raise cv.Invalid("Outdoor-reset points must have distinct outside temperatures")
+    return points
+
+
+RESET_CURVE_SCHEMA = cv.All(
+    cv.ensure_list(RESET_POINT_SCHEMA),
+    cv.Length(min=1, max=OUTDOOR_RESET_MAX_POINTS),
+    validate_reset_curve,
+)
+
+OUTDOOR_RESET_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_HEAT): RESET_CURVE_SCHEMA,
+        cv.Optional(CONF_COOL): RESET_CURVE_SCHEMA,
+    }
+)
+
+
+def pack_schedule_entry(entry):
+    """Mirror of WeeklySchedule::pack()."""
+    days = 0
+    for day in entry[CONF_DAYS_OF_WEEK]:
+        days |= 1 << DAYS_OF_WEEK[day]
+    minute = entry[CONF_TIME][CONF_HOUR] * 60 + entry[CONF_TIME][CONF_MINUTE]
+    return days | (minute << 7) | (PRESETS[entry[CONF_PRESET]] << 18)
+
+
+PRESET_ENTRY_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            # Built-in preset (NONE is manual and always present)...
+            cv.Optional(CONF_PRESET): cv.one_of(*[p for p in PRESETS if p != "NONE"], upper=True),
+            # ...or a custom preset shown by name
+            cv.Optional(CONF_NAME): cv.string_strict,
+            cv.Required(CONF_MIN): cv.use_id(number.Number),
+            cv.Required(CONF_MAX): cv.use_id(number.Number),
+        }
+    ),
+    cv.has_exactly_one_key(CONF_PRESET, CONF_NAME),
+)
+
+# home_min/home_max etc. predate the presets list and are still accepted
+LEGACY_PRESET_KEYS = {
+    "HOME": (CONF_HOME_MIN, CONF_HOME_MAX),
+    "SLEEP": (CONF_SLEEP_MIN, CONF_SLEEP_MAX),
+    "AWAY": (CONF_AWAY_MIN, CONF_AWAY_MAX),
+}
+
+
+def merge_legacy_presets(config):
+    presets = list(config.get(CONF_PRESETS, []))
+    for preset, (min_key, max_key) in LEGACY_PRESET_KEYS.items():
+        if min_key in config or max_key in config:
+            if min_key not in config or max_key not in config:
+                raise cv.Invalid(f"'{min_key}' and '{max_key}' must be given together")
+            presets.append(
+                {CONF_PRESET: preset, CONF_MIN: config.pop(min_key), CONF_MAX: config.pop(max_key)}
+            )
+
+    seen = set()
+    for entry in presets:
+        key = entry.get(CONF_PRESET, entry.get(CONF_NAME))
+        if key in seen:
+            raise cv.Invalid(f"Preset '{key}' is configured more than once")
+        seen.add(key)
+    config[CONF_PRESETS] = presets
+    return config
+
+
+def validate_schedule(config):
+    if CONF_SCHEDULE not in config:
+        return config
+    if CONF_TIME_ID not in config:
+        raise cv.Invalid(f"'{CONF_SCHEDULE}' requires '{CONF_TIME_ID}'")
+    configured = {entry[CONF_PRESET] for entry in config[CONF_PRESETS] if CONF_PRESET in entry}
+    for entry in config[CONF_SCHEDULE]:
+        if entry[CONF_PRESET] != "NONE" and entry[CONF_PRESET] not in configured:
+            raise cv.Invalid(f"Scheduled preset '{entry[CONF_PRESET]}' is not configured")
+    return config
 
 virtual_thermostat_ns = cg.esphome_ns.namespace("virtual_thermostat")
 VirtualThermostat = virtual_thermostat_ns.class_("VirtualThermostat", climate.Climate, cg.Component)
+SchedulePresetAction = virtual_thermostat_ns.class_("SchedulePresetAction", automation.Action)
+ZoneAggregation = virtual_thermostat_ns.enum("ZoneAggregation", is_class=True)
+
+FailsafeMode = virtual_thermostat_ns.enum("FailsafeMode", is_class=True)
+
+FAILSAFE_MODES = {
+    "T1": FailsafeMode.T1,
+    "HOLD": FailsafeMode.HOLD,
+    "OFF": FailsafeMode.OFF,
+}
+
+ZONE_AGGREGATIONS = {
+    "MEAN": ZoneAggregation.MEAN,
+    "MIN": ZoneAggregation.MIN,
+    "MAX": ZoneAggregation.MAX,
+    "OCCUPIED_MEAN": ZoneAggregation.OCCUPIED_MEAN,
+}
+
+ZONE_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_SENSOR): cv.use_id(sensor.Sensor),
+        cv.Optional(CONF_WEIGHT, default=1.0): cv.positive_float,
+        cv.Optional(CONF_OCCUPANCY): cv.use_id(binary_sensor.BinarySensor),
+    }
+)
 
 CONFIG_SCHEMA = climate._CLIMATE_SCHEMA.extend(
     {
@@ -26,18 +215,49 @@ CONFIG_SCHEMA = climate._CLIMATE_SCHEMA.extend(
         cv.Required(CONF_INSIDE_SENSOR): cv.use_id(sensor.Sensor),
         cv.Required(CONF_OUTSIDE_SENSOR): cv.use_id(sensor.Sensor),
         cv.Required(CONF_REAL_CLIMATE): cv.use_id(climate.Climate),
+        cv.Optional(CONF_ADDITIONAL_REAL_CLIMATES): cv.ensure_list(cv.use_id(climate.Climate)),
+        cv.Optional(CONF_ZONES): cv.ensure_list(ZONE_SCHEMA),
+        cv.Optional(CONF_T1_SENSOR): cv.use_id(sensor.Sensor),
+        cv.Optional(CONF_INSIDE_STALE_TIMEOUT, default="30min"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_OUTSIDE_STALE_TIMEOUT, default="2h"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_FAILSAFE_MODE, default="T1"): cv.enum(FAILSAFE_MODES, upper=True),
+        cv.Optional(CONF_FAILSAFE_TEMPERATURE, default=20.0): cv.temperature,
+        cv.Optional(CONF_FAILSAFE_STATE): text_sensor.text_sensor_schema(
+            icon="mdi:shield-alert-outline",
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_ZONE_AGGREGATION, default="MEAN"): cv.enum(ZONE_AGGREGATIONS, upper=True),
+        cv.Optional(CONF_OUTDOOR_RESET): OUTDOOR_RESET_SCHEMA,
 
-        cv.Required(CONF_HOME_MIN): cv.use_id(number.Number),
-        cv.Required(CONF_HOME_MAX): cv.use_id(number.Number),
-        cv.Required(CONF_SLEEP_MIN): cv.use_id(number.Number),
-        cv.Required(CONF_SLEEP_MAX): cv.use_id(number.Number),
-        cv.Required(CONF_AWAY_MIN): cv.use_id(number.Number),
-        cv.Required(CONF_AWAY_MAX): cv.use_id(number.Number),
+        cv.Optional(CONF_PRESETS): cv.ensure_list(PRESET_ENTRY_SCHEMA),
+        cv.Optional(CONF_HOME_MIN): cv.use_id(number.Number),
+        cv.Optional(CONF_HOME_MAX): cv.use_id(number.Number),
+        cv.Optional(CONF_SLEEP_MIN): cv.use_id(number.Number),
+        cv.Optional(CONF_SLEEP_MAX): cv.use_id(number.Number),
+        cv.Optional(CONF_AWAY_MIN): cv.use_id(number.Number),
+        cv.Optional(CONF_AWAY_MAX): cv.use_id(number.Number),
         
         cv.Optional(CONF_UPDATE_INTERVAL, default="30s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_MODE_HYSTERESIS, default=0.5): cv.temperature_delta,
+        cv.Optional(CONF_MIN_MODE_DWELL, default="10min"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_MAX_MODE_CHANGES_PER_HOUR, default=4): cv.int_range(min=0, max=60),
+        cv.Optional(CONF_MAX_PREHEAT_TIME, default="2h"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_SETPOINT_STEP, default=1.0): cv.float_range(min=0.0, max=5.0),
+        cv.Optional(CONF_TRIM_KP, default=1.0): cv.float_range(min=0.0, max=10.0),
+        cv.Optional(CONF_TRIM_KI, default=0.5): cv.float_range(min=0.0, max=10.0),
+        cv.Optional(CONF_MAX_SETPOINT_TRIM, default=2.0): cv.temperature_delta,
+        cv.Optional(CONF_MIN_SETPOINT_INTERVAL, default="10min"): cv.positive_time_period_milliseconds,
+
+        cv.Optional(CONF_TIME_ID): cv.use_id(time.RealTimeClock),
+        cv.Optional(CONF_SCHEDULE): cv.All(
+            cv.ensure_list(SCHEDULE_ENTRY_SCHEMA), cv.Length(min=1, max=255)
+        ),
+        cv.GenerateID(CONF_SCHEDULE_TABLE_ID): cv.declare_id(cg.uint32),
     }
 ).extend(cv.COMPONENT_SCHEMA)
 
+CONFIG_SCHEMA = cv.All(CONFIG_SCHEMA, merge_legacy_presets, validate_schedule)
+
 
 async def to_code(config):
     inside = await cg.get_variable(config[CONF_INSIDE_SENSOR])
@@ -48,21 +268,81 @@ async def to_code(config):
     await cg.register_component(var, config)
     await climate.register_climate(var, config)
 
-    home_min = await cg.get_variable(config[CONF_HOME_MIN])
-    home_max = await cg.get_variable(config[CONF_HOME_MAX])
-    sleep_min = await cg.get_variable(config[CONF_SLEEP_MIN])
-    sleep_max = await cg.get_variable(config[CONF_SLEEP_MAX])
-    away_min = await cg.get_variable(config[CONF_AWAY_MIN])
-    away_max = await cg.get_variable(config[CONF_AWAY_MAX])
+    for real_id in config.get(CONF_ADDITIONAL_REAL_CLIMATES, []):
+        extra = await cg.get_variable(real_id)
+        cg.add(var.add_real_climate(extra))
 
-    cg.add(var.home.min_entity(home_min))
-    cg.add(var.home.max_entity(home_max))
+    cg.add(var.set_zone_aggregation(config[CONF_ZONE_AGGREGATION]))
+    for zone in config.get(CONF_ZONES, []):
+        zone_sensor = await cg.get_variable(zone[CONF_SENSOR])
+        if CONF_OCCUPANCY in zone:
+            occupancy = await cg.get_variable(zone[CONF_OCCUPANCY])
+            cg.add(var.add_zone(zone_sensor, zone[CONF_WEIGHT], occupancy))
+        else:
+            cg.add(var.add_zone(zone_sensor, zone[CONF_WEIGHT]))
 
-    cg.add(var.sleep.min_entity(sleep_min))
-    cg.add(var.sleep.max_entity(sleep_max))
+    if CONF_T1_SENSOR in config:
+        t1 = await cg.get_variable(config[CONF_T1_SENSOR])
+        cg.add(var.set_t1_sensor(t1))
+    cg.add(var.set_inside_stale_timeout(config[CONF_INSIDE_STALE_TIMEOUT]))
+    cg.add(var.set_outside_stale_timeout(config[CONF_OUTSIDE_STALE_TIMEOUT]))
+    cg.add(var.set_failsafe_mode(config[CONF_FAILSAFE_MODE]))
+    cg.add(var.set_failsafe_temperature(config[CONF_FAILSAFE_TEMPERATURE]))
+    if CONF_FAILSAFE_STATE in config:
+        sens = await text_sensor.new_text_sensor(config[CONF_FAILSAFE_STATE])
+        cg.add(var.set_failsafe_state_sensor(sens))
+
+    if CONF_OUTDOOR_RESET in config:
+        for point in config[CONF_OUTDOOR_RESET].get(CONF_HEAT, []):
+            cg.add(var.add_heat_reset_point(point[CONF_OUTSIDE], point[CONF_OFFSET]))
+        for point in config[CONF_OUTDOOR_RESET].get(CONF_COOL, []):
+            cg.add(var.add_cool_reset_point(point[CONF_OUTSIDE], point[CONF_OFFSET]))
+
+    for entry in config[CONF_PRESETS]:
+        min_ = await cg.get_variable(entry[CONF_MIN])
+        max_ = await cg.get_variable(entry[CONF_MAX])
+        if CONF_PRESET in entry:
+            cg.add(var.add_preset(climate.CLIMATE_PRESETS[entry[CONF_PRESET]], min_, max_))
+        else:
+            cg.add(var.add_custom_preset(entry[CONF_NAME], min_, max_))
 
-    cg.add(var.away.min_entity(away_min))
-    cg.add(var.away.max_entity(away_max))
-    
     cg.add(var.set_update_interval(config[CONF_UPDATE_INTERVAL]))
+    cg.add(var.set_mode_hysteresis(config[CONF_MODE_HYSTERESIS]))
+    cg.add(var.set_min_mode_dwell(config[CONF_MIN_MODE_DWELL]))
+    cg.add(var.set_max_mode_changes_per_hour(config[CONF_MAX_MODE_CHANGES_PER_HOUR]))
+    cg.add(var.set_max_preheat_time(config[CONF_MAX_PREHEAT_TIME]))
+    cg.add(var.set_setpoint_step(config[CONF_SETPOINT_STEP]))
+    cg.add(var.set_trim_gains(config[CONF_TRIM_KP], config[CONF_TRIM_KI]))
+    cg.add(var.set_max_setpoint_trim(config[CONF_MAX_SETPOINT_TRIM]))
+    cg.add(var.set_min_setpoint_interval(config[CONF_MIN_SETPOINT_INTERVAL]))
+
+    if CONF_TIME_ID in config:
+        rtc = await cg.get_variable(config[CONF_TIME_ID])
+        cg.add(var.set_time(rtc))
+    if CONF_SCHEDULE in config:
+        packed = [pack_schedule_entry(entry) for entry in config[CONF_SCHEDULE]]
+        table = cg.static_const_array(config[CONF_SCHEDULE_TABLE_ID], cg.ArrayInitializer(*packed))
+        cg.add(var.set_schedule(table, len(packed)))
+
+
+@automation.register_action(
+    "virtual_thermostat.schedule_preset",
+    SchedulePresetAction,
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.use_id(VirtualThermostat),
+            cv.Required(CONF_PRESET): cv.templatable(climate.validate_climate_preset),
+            cv.Optional(CONF_DELAY, default="0s"): cv.templatable(cv.positive_time_period_milliseconds),
+        }
+    ),
+)
+async def schedule_preset_to_code(config, action_id, template_arg, args):
+    parent = await cg.get_variable(config[CONF_ID])
+    var = cg.new_Pvariable(action_id, template_arg)
+    cg.add(var.set_parent(parent))
+    template_ = await cg.templatable(config[CONF_PRESET], args, climate.ClimatePreset)
+    cg.add(var.set_preset(template_))
+    template_ = await cg.templatable(config[CONF_DELAY], args, cg.uint32)
+    cg.add(var.set_delay(template_))
+    return var
 
@@ -0,0 +1,87 @@
+#include "mode_arbiter.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace virtual_thermostat {
+
+static constexpr float MS_PER_HOUR = 3600.0f * 1000.0f;
+
+void ModeArbiter::set_max_changes_per_hour(uint8_t changes) {
+  this->max_changes_per_hour_ = changes;
+  this->tokens_ = changes;  // Start with a full bucket
+}
+
+ArbiterMode ModeArbiter::desired_(float inside, float outside, float low, float high) const {
+  // Thresholds that would take us out of the current mode are pushed out by the hysteresis
+  const float h = this->hysteresis_;
+  const float heat_below = low - (this->mode_ == ArbiterMode::COOL ? h : 0.0f);
+  const float cool_above = high + (this->mode_ == ArbiterMode::HEAT ? h : 0.0f);
+
+  if (inside < heat_below)
+    return ArbiterMode::HEAT;  // too cold, need heating
+  if (inside > cool_above)
+    return ArbiterMode::COOL;  // too hot, need cooling
+
+  // Within range: stay ready in the direction the house is drifting.
+  // Prefer the outside temperature, fall back to the inside position within the band.
+  const float mid_point = (low + high) / 2.0f;
+  const float reference = std::isnan(outside) ? inside : outside;
+  switch (this->mode_) {
+    case ArbiterMode::HEAT:
+      return reference > mid_point + h ? ArbiterMode::COOL : ArbiterMode::HEAT;
+    case ArbiterMode::COOL:
+      return reference < mid_point - h ? ArbiterMode::HEAT : ArbiterMode::COOL;
+    default:
+      return reference < mid_point ? ArbiterMode::HEAT : ArbiterMode::COOL;
+  }
+}
+
+float ModeArbiter::refilled_tokens_(uint32_t now) const {
+  const float rate = this->max_changes_per_hour_ / MS_PER_HOUR;
+  const float tokens = this->tokens_ + (now - this->tokens_at_) * rate;
+  return tokens > this->max_changes_per_hour_ ? this->max_changes_per_hour_ : tokens;
+}
+
+bool ModeArbiter::may_change_(uint32_t now) const {
+  if (now - this->changed_at_ < this->min_dwell_ms_)
+    return false;
+  if (this->max_changes_per_hour_ == 0)
+    return true;  // Rate limit disabled
+  return this->refilled_tokens_(now) >= 1.0f;
+}
+
+ArbiterMode ModeArbiter::peek(float inside, float outside, float low, float high, uint32_t now) const {
+  if (std::isnan(inside) || std::isnan(low) || std::isnan(high))
+    return this->mode_;
+
+  const ArbiterMode wanted = this->desired_(inside, outside, low, high);
+  if (wanted == this->mode_)
+    return this->mode_;
+  // The very first decision is free; every reversal after that is rate limited
+  if (this->mode_ != ArbiterMode::NONE && !this->may_change_(now))
+    return this->mode_;
+  return wanted;
+}
+
+ArbiterMode ModeArbiter::evaluate(float inside, float outside, float low, float high, uint32_t now) {
+  const ArbiterMode decided = this->peek(inside, outside, low, high, now);
+  if (decided == this->mode_) {
+    // Held back: a different mode is wanted but the dwell or rate limit keeps the current one
+    this->holding_ = !std::isnan(inside) && !std::isnan(low) && !std::isnan(high) &&
+                     this->desired_(inside, outside, low, high) != this->mode_;
+    return this->mode_;
+  }
+  this->holding_ = false;
+
+  if (this->mode_ != ArbiterMode::NONE && this->max_changes_per_hour_ != 0) {
+    this->tokens_ = this->refilled_tokens_(now) - 1.0f;
+  }
+  this->tokens_at_ = now;
+  this->mode_ = decided;
+  this->changed_at_ = now;
+  return this->mode_;
+}
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
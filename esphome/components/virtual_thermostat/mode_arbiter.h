@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace virtual_thermostat {
+
+// Direction the real climate is kept ready for
+enum class ArbiterMode : uint8_t {
+  NONE = 0,  // No decision made yet
+  HEAT = 1,
+  COOL = 2,
+};
+
+// HEAT/COOL arbitration for the real climate.
+//
+// Replaces plain threshold compares with:
+//  - hysteresis: leaving the current mode requires crossing the threshold by an extra margin
+//  - minimum dwell: a mode is held for at least this long once entered
+//  - rate limit: token bucket allowing at most N mode changes per hour
+//
+// Every reversal costs the heat pump a reversing-valve/defrost cycle, so a noisy
+// sensor near the midpoint must not be able to flip the mode back and forth.
+class ModeArbiter {
+ public:
+  void set_hysteresis(float hysteresis) { this->hysteresis_ = hysteresis; }
+  void set_min_dwell(uint32_t ms) { this->min_dwell_ms_ = ms; }
+  void set_max_changes_per_hour(uint8_t changes);
+
+  // Evaluate the inputs and commit the result. 'outside' may be NaN when unavailable.
+  // Returns the mode to use, which is the current mode while a change is being held back.
+  // Only call this when the result is actually sent to the real climate: a change
+  // starts the dwell and spends a token.
+  ArbiterMode evaluate(float inside, float outside, float low, float high, uint32_t now);
+  // What evaluate() would return right now, without changing any state (logging, previews)
+  ArbiterMode peek(float inside, float outside, float low, float high, uint32_t now) const;
+
+  ArbiterMode mode() const { return this->mode_; }
+  // Whether the last evaluate() wanted a different mode than it returned
+  bool is_holding() const { return this->holding_; }
+
+ protected:
+  ArbiterMode desired_(float inside, float outside, float low, float high) const;
+  bool may_change_(uint32_t now) const;
+  // Bucket content at 'now', refilled for the time since tokens_at_
+  float refilled_tokens_(uint32_t now) const;
+
+  float hysteresis_{0.5f};
+  uint32_t min_dwell_ms_{10 * 60 * 1000};
+  uint8_t max_changes_per_hour_{4};
+
+  ArbiterMode mode_{ArbiterMode::NONE};
+  bool holding_{false};
+  uint32_t changed_at_{0};
+  float tokens_{0.0f};
+  uint32_t tokens_at_{0};
+};
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
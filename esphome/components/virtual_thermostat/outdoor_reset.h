@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace virtual_thermostat {
+
+// Piecewise-linear outdoor-reset (weather compensation) curve: maps the outside
+// temperature to an offset applied to the real climate's setpoint.
+//
+// Points must be added in ascending outside temperature (codegen sorts them).
+// Outside the covered range the end offsets are held. An empty curve, or an
+// unavailable outside temperature, yields no offset.
+class OutdoorResetCurve {
+ public:
+  static constexpr uint8_t MAX_POINTS = 8;
+
+  constexpr OutdoorResetCurve() = default;
+
+  constexpr bool add_point(float outside, float offset) {
+    if (this->count_ >= MAX_POINTS)
+      return false;
+    this->outside_[this->count_] = outside;
+    this->offset_[this->count_] = offset;
+    this->count_++;
+    return true;
+  }
+
+  constexpr bool empty() const { return this->count_ == 0; }
+
+  constexpr float evaluate(float outside) const {
+    // outside != outside: NaN test that stays usable in constant expressions
+    if (this->count_ == 0 || outside != outside)
+      return 0.0f;
+    if (outside <= this->outside_[0])
+      return this->offset_[0];
+    for (uint8_t i = 1; i < this->count_; i++) {
+      if (outside <= this->outside_[i]) {
+        const float span = this->outside_[i] - this->outside_[i - 1];
+        const float t = span > 0.0f ? (outside - this->outside_[i - 1]) / span : 1.0f;
+        return this->offset_[i - 1] + t * (this->offset_[i] - this->offset_[i - 1]);
+      }
+    }
+    return this->offset_[this->count_ - 1];
+  }
+
+ protected:
+  float outside_[MAX_POINTS]{};
+  float offset_[MAX_POINTS]{};
+  uint8_t count_{0};
+};
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
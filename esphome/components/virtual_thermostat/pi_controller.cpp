@@ -0,0 +1,73 @@
+#include "pi_controller.h"
+
+namespace esphome {
+namespace virtual_thermostat {
+
+static constexpr float MS_PER_HOUR = 3600.0f * 1000.0f;
+// A command within this many steps of the wanted value is kept: the half step at
+// which rounding would pick the neighbour, plus a quarter step of hysteresis
+static constexpr float DEADBAND_STEPS = 0.75f;
+
+float PiController::quantize(float value) const {
+  if (this->step_ <= 0.0f || std::isnan(value))
+    return value;
+  return std::round(value / this->step_) * this->step_;
+}
+
+void PiController::reset() {
+  this->integral_ = 0.0f;
+  this->trim_ = 0.0f;
+  this->setpoint_ = NAN;
+  this->command_ = NAN;
+  this->running_ = false;
+}
+
+float PiController::update(float setpoint, float measured, uint32_t now) {
+  if (std::isnan(setpoint))
+    return this->command_;
+
+  if (!std::isnan(measured)) {
+    const float error = setpoint - measured;
+    const float dt_hours = this->running_ ? (now - this->sampled_at_) / MS_PER_HOUR : 0.0f;
+    this->running_ = true;
+    this->sampled_at_ = now;
+
+    const float proportional = this->kp_ * error;
+    const float integral = this->integral_ + this->ki_ * error * dt_hours;
+    const float unclamped = proportional + integral;
+    // Integrate only while unsaturated, or when the error pulls the output back in
+    if (std::fabs(unclamped) <= this->max_trim_ || (unclamped > 0.0f) != (error > 0.0f)) {
+      this->integral_ = std::fmax(-this->max_trim_, std::fmin(this->max_trim_, integral));
+    }
+    this->trim_ = std::fmax(-this->max_trim_, std::fmin(this->max_trim_, proportional + this->integral_));
+  } else {
+    // Blind: keep the last trim, and do not integrate over the gap once samples return
+    this->running_ = false;
+  }
+
+  const float wanted = setpoint + this->trim_;
+  const bool jumped = !std::isnan(this->setpoint_) &&
+                      std::fabs(setpoint - this->setpoint_) >= std::fmax(this->step_, 0.5f);
+  this->setpoint_ = setpoint;
+  if (std::isnan(this->command_) || jumped) {
+    this->command_ = this->quantize(wanted);
+    this->changed_at_ = now;
+    return this->command_;
+  }
+
+  if (std::fabs(wanted - this->command_) < this->step_ * DEADBAND_STEPS)
+    return this->command_;
+  if (now - this->changed_at_ < this->min_interval_ms_)
+    return this->command_;
+
+  if (this->step_ > 0.0f) {
+    this->command_ += wanted > this->command_ ? this->step_ : -this->step_;
+  } else {
+    this->command_ = wanted;
+  }
+  this->changed_at_ = now;
+  return this->command_;
+}
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace virtual_thermostat {
+
+// Closed-loop trim of the real climate's setpoint.
+//
+// The unit regulates against its own sensor, so passing the band target straight
+// through leaves the room with a persistent offset. This PI controller adds a trim
+// proportional to the room error plus its integral, and turns the result into a
+// command the unit can actually represent:
+//  - anti-windup: the integral only moves while the trim is not saturated in the
+//    direction the error pushes (conditional integration)
+//  - quantization: the command is a multiple of the unit's setpoint step and only
+//    moves once the wanted value is 0.75 step away, i.e. past the half-step where
+//    rounding would flip plus a quarter-step of hysteresis, so it does not chatter
+//    around a rounding boundary
+//  - rate limit: the command moves at most one step per min_interval
+// A setpoint jump of a step or more (preset change, band edit) re-bases the command
+// immediately instead of slewing towards it.
+class PiController {
+ public:
+  // ki is in °C of trim per °C of error per hour
+  void set_gains(float kp, float ki) {
+    this->kp_ = kp;
+    this->ki_ = ki;
+  }
+  // 0 disables the trim; the command is then the quantized setpoint
+  void set_max_trim(float max_trim) { this->max_trim_ = max_trim; }
+  // 0 disables quantization
+  void set_step(float step) { this->step_ = step; }
+  void set_min_interval(uint32_t ms) { this->min_interval_ms_ = ms; }
+
+  // Feed one sample. 'measured' may be NaN, which holds the current trim.
+  // Returns the command, NaN until a setpoint has been seen.
+  float update(float setpoint, float measured, uint32_t now);
+
+  // Last command, NaN after reset() until the next update()
+  float command() const { return this->command_; }
+  float trim() const { return this->trim_; }
+  float quantize(float value) const;
+
+  // Forget the integral and the command, e.g. when the regulated quantity changes meaning
+  void reset();
+
+ protected:
+  float kp_{1.0f};
+  float ki_{0.5f};
+  float max_trim_{2.0f};
+  float step_{1.0f};
+  uint32_t min_interval_ms_{10 * 60 * 1000};
+
+  float integral_{0.0f};
+  float trim_{0.0f};
+  float setpoint_{NAN};
+  float command_{NAN};
+  bool running_{false};
+  uint32_t sampled_at_{0};
+  uint32_t changed_at_{0};
+};
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
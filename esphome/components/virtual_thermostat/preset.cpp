@@ -17,6 +17,10 @@ void Preset::max_entity(number::Number *n) {
   }
 }
 
+bool Preset::is_manual() const {
+  return this == &thermostat->manual;
+}
+
 float Preset::min() const {
   return (min_entity_ && min_entity_->has_state()) ? min_entity_->state : thermostat->target_temperature_low;
 }
@@ -25,15 +29,31 @@ float Preset::max() const {
   return (max_entity_ && max_entity_->has_state()) ? max_entity_->state : thermostat->target_temperature_high;
 }
 
-float Preset::getTargetTemperatureForRealClimate() const {
+float Preset::mid() const {
   return (min() + max()) / 2.0f;
 }
 
-float Preset::getCurrentInsideTemperatureForRealClimate() const {
-  if (thermostat->inside_sensor_ != nullptr && thermostat->inside_sensor_->has_state()) {
-    return thermostat->inside_sensor_->state;
+float Preset::getTargetTemperatureForRealClimate() const {
+  if (is_manual()) {
+    return mid();
   }
-  return NAN;
+  // The trim controller's command is already quantized to the unit's step and rate limited
+  const float command = thermostat->pi_.command();
+  return std::isnan(command) ? thermostat->pi_.quantize(getRegulatedTemperature()) : command;
+}
+
+float Preset::getRegulatedTemperature() const {
+  if (is_manual()) {
+    return mid();
+  }
+  // Weather compensation: shift the setpoint with the outside temperature, but never out of the band
+  const float target = mid() + thermostat->outdoor_reset_offset();
+  return std::max(min(), std::min(max(), target));
+}
+
+float Preset::getCurrentInsideTemperatureForRealClimate() const {
+  // Zone aggregate, filtered and fused with T1 (NaN when no input is fresh)
+  return thermostat->fusion_.estimate(millis());
 }
 
 climate::ClimateFanMode Preset::getFanModeForRealClimate() const {
@@ -41,7 +61,7 @@ climate::ClimateFanMode Preset::getFanModeForRealClimate() const {
 }
 
 climate::ClimateMode Preset::getModeForVirtualThermostat() const {
-  if (id != climate::CLIMATE_PRESET_NONE) {
+  if (!is_manual()) {
     return climate::CLIMATE_MODE_AUTO;
   } else {
     // In manual mode, keep the current mode of the virtual thermostat
@@ -50,13 +70,17 @@ climate::ClimateMode Preset::getModeForVirtualThermostat() const {
   }
 }
 
-optional<climate::ClimateMode> Preset::getModeForRealClimate() const {
+optional<climate::ClimateMode> Preset::getModeForRealClimate() const { return selectModeForRealClimate(false); }
+
+optional<climate::ClimateMode> Preset::decideModeForRealClimate() const { return selectModeForRealClimate(true); }
+
+optional<climate::ClimateMode> Preset::selectModeForRealClimate(bool commit) const {
   // If there's no real climate device, return empty optional
   if (thermostat->real_climate_ == nullptr) {
     return {};
   }
   
-  if (id != climate::CLIMATE_PRESET_NONE) {
+  if (!is_manual()) {
     const auto temp = getTargetTemperatureForRealClimate();
     const auto inside_temp = getCurrentInsideTemperatureForRealClimate();
     // Handle NaN case when inside sensor is unavailable
@@ -67,37 +91,22 @@ optional<climate::ClimateMode> Preset::getModeForRealClimate() const {
       return thermostat->real_climate_->mode;
     }
     
-    // Check if inside temperature is outside the range
-    if (inside_temp < min()) {
-      return climate::CLIMATE_MODE_HEAT; // inside_temp too cold, need heating
-    } else if (inside_temp > max()) {
-      return climate::CLIMATE_MODE_COOL; // inside_temp too hot, need cooling
-    } else {
-      // Inside temperature is within range
-      // Calculate midpoint once for use in both outside sensor logic and fallback
-      const float mid_point = (min() + max()) / 2.0f;
-      
-      // Use outside temperature sensor to decide between cool or heat
-      // This keeps the real thermostat ready in the appropriate mode
-      if (thermostat->outside_sensor_ != nullptr && thermostat->outside_sensor_->has_state()) {
-        const auto outside_temp = thermostat->outside_sensor_->state;
-        if (!std::isnan(outside_temp)) {
-          // Use outside temp to decide mode - if it's hot outside, stay ready to cool
-          // if it's cold outside, stay ready to heat
-          if (outside_temp < mid_point) {
-            return climate::CLIMATE_MODE_HEAT; // cold outside, stay ready to heat
-          } else {
-            return climate::CLIMATE_MODE_COOL; // warm outside, stay ready to cool
-          }
-        }
-      }
-      
-      // Fallback: If outside sensor unavailable, use inside temp position within range
-      if (inside_temp < mid_point) {
-        return climate::CLIMATE_MODE_HEAT; // closer to min, stay ready to heat
-      } else {
-        return climate::CLIMATE_MODE_COOL; // closer to max, stay ready to cool
-      }
+    const float outside_temp = thermostat->outside_temperature();
+
+    // Hysteresis, minimum dwell and rate limiting live in the arbiter so a noisy
+    // sensor near a threshold cannot reverse the heat pump on every sample
+    const auto decision = commit ? thermostat->arbiter_.evaluate(inside_temp, outside_temp, min(), max(), millis())
+                                 : thermostat->arbiter_.peek(inside_temp, outside_temp, min(), max(), millis());
+    if (commit && thermostat->arbiter_.is_holding()) {
+      ESP_LOGV("virtual_thermostat", "Mode change held back by dwell/rate limit");
+    }
+    switch (decision) {
+      case ArbiterMode::HEAT:
+        return climate::CLIMATE_MODE_HEAT;
+      case ArbiterMode::COOL:
+        return climate::CLIMATE_MODE_COOL;
+      default:
+        return thermostat->real_climate_->mode;
     }
   }
   else {
@@ -133,7 +142,7 @@ void Preset::on_min_changed(float new_min) {
   }
   
   // If this is the active preset, update the thermostat's target temperatures
-  if (thermostat->preset == id && thermostat->mode == climate::CLIMATE_MODE_AUTO) {
+  if (&thermostat->getActivePreset() == this && thermostat->mode == climate::CLIMATE_MODE_AUTO) {
     thermostat->target_temperature_low = new_min;
     if (new_min >= thermostat->target_temperature_high) {
       thermostat->target_temperature_high = new_min + MIN_TEMP_DIFF;
@@ -170,7 +179,7 @@ void Preset::on_max_changed(float new_max) {
   }
   
   // If this is the active preset, update the thermostat's target temperatures
-  if (thermostat->preset == id && thermostat->mode == climate::CLIMATE_MODE_AUTO) {
+  if (&thermostat->getActivePreset() == this && thermostat->mode == climate::CLIMATE_MODE_AUTO) {
     thermostat->target_temperature_high = new_max;
     if (new_max <= thermostat->target_temperature_low) {
       thermostat->target_temperature_low = new_max - MIN_TEMP_DIFF;
@@ -14,12 +14,18 @@ constexpr float MIN_TEMP_DIFF = 1.0f;
 struct Preset {
   Preset() = delete;
   Preset(climate::ClimatePreset id, VirtualThermostat *thermostat) : id(id), thermostat(thermostat) {}
+  Preset(const char *name, VirtualThermostat *thermostat)
+      : id(climate::CLIMATE_PRESET_NONE), name(name), thermostat(thermostat) {}
   climate::ClimatePreset id;
+  const char *name{nullptr};  // Custom preset name, nullptr for built-in presets
+
+  bool is_manual() const;
   
   // IMPORTANT: Callback lifetime safety
   // min_entity() and max_entity() register callbacks that capture 'this' pointer.
-  // These Preset objects are member variables of VirtualThermostat (not dynamically allocated),
-  // ensuring they have the same lifetime as the VirtualThermostat instance.
+  // Manual is a member of VirtualThermostat; configured presets are allocated once during
+  // setup by VirtualThermostat::add_preset() and never freed. Either way they live as long
+  // as the VirtualThermostat instance.
   // The number entities are also owned by ESPHome's component system and will not outlive
   // the VirtualThermostat, making these callbacks safe from dangling pointer issues.
   void min_entity(number::Number *n);
@@ -28,15 +34,24 @@ struct Preset {
   float min() const;
   float max() const;
 
+  // Middle of the band
+  float mid() const;
+
   float getTargetTemperatureForRealClimate() const;
 
+  // Band target before the closed-loop trim (weather compensated, clamped to the band)
+  float getRegulatedTemperature() const;
+
   float getCurrentInsideTemperatureForRealClimate() const;
 
   climate::ClimateFanMode getFanModeForRealClimate() const;
 
   climate::ClimateMode getModeForVirtualThermostat() const;
 
+  // Mode the arbiter would pick now, without committing it (logging, previews)
   optional<climate::ClimateMode> getModeForRealClimate() const;
+  // Commits the arbiter decision; only for a transaction that is actually sent
+  optional<climate::ClimateMode> decideModeForRealClimate() const;
 
 private:
   number::Number *min_entity_{nullptr};
@@ -44,6 +59,7 @@ private:
   VirtualThermostat *thermostat{nullptr};
   bool updating_{false};  // Guard flag to prevent recursive updates
   
+  optional<climate::ClimateMode> selectModeForRealClimate(bool commit) const;
   void on_min_changed(float new_min);
   void on_max_changed(float new_max);
 };
@@ -0,0 +1,41 @@
+#include "real_climate_transaction.h"
+
+namespace esphome {
+namespace virtual_thermostat {
+
+bool RealClimateTransaction::commit_to(climate::Climate *climate) const {
+  if (climate == nullptr) return false;
+
+  auto call = climate->make_call();
+  bool changed = false;
+
+  if (this->mode_.has_value() && climate->mode != *this->mode_) {
+    call.set_mode(*this->mode_);
+    changed = true;
+  }
+  if (this->target_temperature_.has_value() && !std::isnan(*this->target_temperature_) &&
+      climate->target_temperature != *this->target_temperature_) {
+    call.set_target_temperature(*this->target_temperature_);
+    changed = true;
+  }
+  if (this->fan_mode_.has_value() && climate->fan_mode != *this->fan_mode_) {
+    call.set_fan_mode(*this->fan_mode_);
+    changed = true;
+  }
+
+  if (changed) {
+    call.perform();
+  }
+  return changed;
+}
+
+bool RealClimateTransaction::commit() {
+  const bool changed = this->commit_to(this->real_climate_);
+  this->mode_.reset();
+  this->target_temperature_.reset();
+  this->fan_mode_.reset();
+  return changed;
+}
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
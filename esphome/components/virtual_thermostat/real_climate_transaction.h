@@ -0,0 +1,37 @@
+#pragma once
+
+#include "esphome.h"
+
+namespace esphome {
+namespace virtual_thermostat {
+
+// Accumulates the changes one pass wants to make to the real climate and
+// commits them as a single ClimateCall. Going through make_call() runs the
+// device's control(), so each user action sends exactly one SET downstream
+// instead of only publishing a state the device never acted on.
+class RealClimateTransaction {
+ public:
+  explicit RealClimateTransaction(climate::Climate *real_climate) : real_climate_(real_climate) {}
+
+  // Later calls overwrite earlier ones, so repeated apply_preset() calls collapse
+  void set_mode(climate::ClimateMode mode) { this->mode_ = mode; }
+  void set_target_temperature(float temperature) { this->target_temperature_ = temperature; }
+  void set_fan_mode(climate::ClimateFanMode fan_mode) { this->fan_mode_ = fan_mode; }
+
+  const optional<float> &get_target_temperature() const { return this->target_temperature_; }
+
+  // Perform one call carrying only the fields that differ from the real climate's state.
+  // Returns true if a call was performed.
+  bool commit();
+  // Same for another climate driven by the same pass; does not clear the transaction
+  bool commit_to(climate::Climate *climate) const;
+
+ protected:
+  climate::Climate *real_climate_{nullptr};
+  optional<climate::ClimateMode> mode_;
+  optional<float> target_temperature_;
+  optional<climate::ClimateFanMode> fan_mode_;
+};
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
@@ -0,0 +1,111 @@
+#include "recovery_model.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace virtual_thermostat {
+
+// Weight kept by older samples each time a new one arrives (~50 sample memory)
+static constexpr float FORGETTING_FACTOR = 0.98f;
+// Samples needed before the fit replaces the fallback rate
+static constexpr float MIN_SAMPLE_WEIGHT = 3.0f;
+// Predicted rates are clamped so a bad fit cannot produce absurd lead times
+static constexpr float MIN_RATE = 0.1f;
+static constexpr float MAX_RATE = 10.0f;
+static constexpr float MS_PER_HOUR = 3600.0f * 1000.0f;
+
+void RateFit::add(float outside, float rate) {
+  this->sw = this->sw * FORGETTING_FACTOR + 1.0f;
+  this->sx = this->sx * FORGETTING_FACTOR + outside;
+  this->sy = this->sy * FORGETTING_FACTOR + rate;
+  this->sxx = this->sxx * FORGETTING_FACTOR + outside * outside;
+  this->sxy = this->sxy * FORGETTING_FACTOR + outside * rate;
+}
+
+float RateFit::predict(float outside, float fallback) const {
+  if (this->sw < MIN_SAMPLE_WEIGHT)
+    return fallback;
+
+  float rate = this->sy / this->sw;
+  // Only use the slope once the samples span a few degrees of outside temperature
+  const float det = this->sw * this->sxx - this->sx * this->sx;
+  if (!std::isnan(outside) && det > 4.0f * this->sw * this->sw) {
+    const float slope = (this->sw * this->sxy - this->sx * this->sy) / det;
+    const float intercept = (this->sy - slope * this->sx) / this->sw;
+    rate = intercept + slope * outside;
+  }
+  if (rate < MIN_RATE)
+    return MIN_RATE;
+  if (rate > MAX_RATE)
+    return MAX_RATE;
+  return rate;
+}
+
+void RecoveryModel::restart_window_(float inside, RecoveryPhase phase, uint32_t now) {
+  this->window_phase_ = phase;
+  this->window_start_ = now;
+  this->window_start_temp_ = inside;
+  this->window_outside_sum_ = 0.0f;
+  this->window_outside_count_ = 0;
+}
+
+void RecoveryModel::observe(float inside, float outside, RecoveryPhase phase, uint32_t now) {
+  if (std::isnan(inside)) {
+    this->restart_window_(inside, RecoveryPhase::IDLE, now);
+    return;
+  }
+  if (!std::isnan(outside))
+    this->last_outside_ = outside;
+
+  if (phase != this->window_phase_ || std::isnan(this->window_start_temp_)) {
+    this->restart_window_(inside, phase, now);
+    return;
+  }
+
+  this->window_outside_sum_ += this->last_outside_;
+  this->window_outside_count_++;
+
+  const uint32_t elapsed = now - this->window_start_;
+  if (elapsed < SAMPLE_WINDOW_MS)
+    return;
+
+  if (phase != RecoveryPhase::IDLE) {
+    const float hours = elapsed / MS_PER_HOUR;
+    const float delta = inside - this->window_start_temp_;
+    const float rate = (phase == RecoveryPhase::HEATING ? delta : -delta) / hours;
+    const float mean_outside = this->window_outside_sum_ / this->window_outside_count_;
+    // A window where the house moved the wrong way says nothing about capacity
+    if (rate > 0.0f) {
+      (phase == RecoveryPhase::HEATING ? this->heating_ : this->cooling_).add(mean_outside, rate);
+    }
+  }
+  this->restart_window_(inside, phase, now);
+}
+
+float RecoveryModel::heating_rate(float outside) const {
+  return this->heating_.predict(outside, DEFAULT_HEATING_RATE);
+}
+
+float RecoveryModel::cooling_rate(float outside) const {
+  return this->cooling_.predict(outside, DEFAULT_COOLING_RATE);
+}
+
+uint32_t RecoveryModel::lead_time(float inside, float low, float high, float outside, uint32_t max_lead) const {
+  if (std::isnan(inside))
+    return 0;
+
+  float hours;
+  if (inside < low) {
+    hours = (low - inside) / this->heating_rate(outside);
+  } else if (inside > high) {
+    hours = (inside - high) / this->cooling_rate(outside);
+  } else {
+    return 0;
+  }
+
+  const float lead = hours * MS_PER_HOUR;
+  return lead >= max_lead ? max_lead : static_cast<uint32_t>(lead);
+}
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
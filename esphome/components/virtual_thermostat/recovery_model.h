@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace virtual_thermostat {
+
+// What the real climate is doing while a sample window is open
+enum class RecoveryPhase : uint8_t {
+  IDLE = 0,
+  HEATING = 1,
+  COOLING = 2,
+};
+
+// Exponentially weighted least-squares fit of recovery rate (°C/hour) against
+// outside temperature: rate = a + b * outside. Running sums only, O(1) per sample.
+struct RateFit {
+  float sw{0.0f};
+  float sx{0.0f};
+  float sy{0.0f};
+  float sxx{0.0f};
+  float sxy{0.0f};
+
+  void add(float outside, float rate);
+  // Predicted rate at 'outside', or 'fallback' until enough samples have been seen
+  float predict(float outside, float fallback) const;
+};
+
+// Learns how fast the house heats and cools and predicts how early a preset
+// transition has to start so the new band is reached at the scheduled time.
+//
+// Fed once per sync tick. While the real climate keeps heating (or cooling) a
+// window is kept open; every SAMPLE_WINDOW_MS the inside temperature change over
+// the window becomes one rate sample at the window's mean outside temperature.
+class RecoveryModel {
+ public:
+  static constexpr uint32_t SAMPLE_WINDOW_MS = 10 * 60 * 1000;
+  static constexpr float DEFAULT_HEATING_RATE = 1.0f;  // °C/hour until learned
+  static constexpr float DEFAULT_COOLING_RATE = 1.0f;
+
+  // 'outside' may be NaN when unavailable
+  void observe(float inside, float outside, RecoveryPhase phase, uint32_t now);
+
+  float heating_rate(float outside) const;
+  float cooling_rate(float outside) const;
+
+  // Time needed to bring 'inside' into [low, high], capped at 'max_lead' (0 when already inside)
+  uint32_t lead_time(float inside, float low, float high, float outside, uint32_t max_lead) const;
+
+ protected:
+  void restart_window_(float inside, RecoveryPhase phase, uint32_t now);
+
+  RateFit heating_;
+  RateFit cooling_;
+
+  RecoveryPhase window_phase_{RecoveryPhase::IDLE};
+  uint32_t window_start_{0};
+  float window_start_temp_{0.0f};
+  float window_outside_sum_{0.0f};
+  uint16_t window_outside_count_{0};
+  float last_outside_{0.0f};
+};
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
@@ -0,0 +1,122 @@
+#include "sensor_fusion.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace virtual_thermostat {
+
+// Process noise: how fast the room temperature may wander, in °C² per hour
+static constexpr float PROCESS_NOISE = 0.5f;
+// Measurement noise (°C²) of the room sensor and of bias-corrected T1
+static constexpr float ROOM_NOISE = 0.04f;
+static constexpr float REFERENCE_NOISE = 1.0f;
+// Smoothing of the T1 bias estimate
+static constexpr float BIAS_ALPHA = 0.05f;
+static constexpr float MS_PER_HOUR = 3600.0f * 1000.0f;
+
+static float median3(float a, float b, float c) {
+  if (a > b) {
+    const float t = a;
+    a = b;
+    b = t;
+  }
+  if (b > c)
+    b = c;
+  return a > b ? a : b;
+}
+
+bool SensorFusion::fresh_(uint32_t at, uint32_t now) const {
+  if (at == 0)
+    return false;
+  return this->stale_timeout_ == 0 || now - at < this->stale_timeout_;
+}
+
+bool SensorFusion::lost(uint32_t now) const {
+  if (this->room_fresh(now) || this->reference_fresh(now))
+    return false;
+  if (this->room_at_ != 0 || this->reference_at_ != 0)
+    return true;
+  return this->stale_timeout_ != 0 && now - this->started_at_ >= this->stale_timeout_;
+}
+
+void SensorFusion::predict_(uint32_t now) {
+  this->p_ += PROCESS_NOISE * ((now - this->predicted_at_) / MS_PER_HOUR);
+  this->predicted_at_ = now;
+}
+
+void SensorFusion::correct_(float measurement, float noise) {
+  const float gain = this->p_ / (this->p_ + noise);
+  this->x_ += gain * (measurement - this->x_);
+  this->p_ *= 1.0f - gain;
+}
+
+void SensorFusion::add_room(float value, uint32_t now) {
+  if (std::isnan(value))
+    return;
+  // Timestamps of 0 mean "never"
+  if (now == 0)
+    now = 1;
+
+  // After an outage the old samples say nothing about the room any more
+  const bool was_fresh = this->room_fresh(now);
+  if (!was_fresh) {
+    this->window_fill_ = 0;
+    this->window_pos_ = 0;
+  }
+
+  this->window_[this->window_pos_] = value;
+  this->window_pos_ = (this->window_pos_ + 1) % 3;
+  if (this->window_fill_ < 3)
+    this->window_fill_++;
+  const float filtered =
+      this->window_fill_ < 3 ? value : median3(this->window_[0], this->window_[1], this->window_[2]);
+  this->room_at_ = now;
+
+  // Start over from the sensor unless T1 has been carrying the estimate meanwhile
+  if (!this->initialized_ || (!was_fresh && !this->reference_fresh(now))) {
+    this->x_ = filtered;
+    this->p_ = ROOM_NOISE;
+    this->predicted_at_ = now;
+    this->initialized_ = true;
+    return;
+  }
+  this->predict_(now);
+  this->correct_(filtered, ROOM_NOISE);
+}
+
+void SensorFusion::add_reference(float value, uint32_t now) {
+  if (std::isnan(value))
+    return;
+  if (now == 0)
+    now = 1;
+  this->reference_at_ = now;
+
+  if (this->room_fresh(now)) {
+    // Learn how far T1 sits from the room while both are available
+    const float offset = value - this->x_;
+    this->bias_ = this->bias_known_ ? this->bias_ + BIAS_ALPHA * (offset - this->bias_) : offset;
+    this->bias_known_ = true;
+    return;
+  }
+
+  // Room sensor stale: T1 carries the estimate
+  const float corrected = value - this->bias_;
+  if (!this->initialized_) {
+    this->x_ = corrected;
+    this->p_ = REFERENCE_NOISE;
+    this->predicted_at_ = now;
+    this->initialized_ = true;
+    return;
+  }
+  this->predict_(now);
+  this->correct_(corrected, REFERENCE_NOISE);
+}
+
+float SensorFusion::estimate(uint32_t now) const {
+  if (!this->initialized_ || (!this->room_fresh(now) && !this->reference_fresh(now)))
+    return NAN;
+  return this->x_;
+}
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace virtual_thermostat {
+
+// Fuses the room temperature with the unit's own return-air reading (T1).
+//
+// Room samples pass a median-of-3 filter, so a single glitch is dropped, and then
+// feed a scalar Kalman filter (random-walk model). While the room sensor is fresh,
+// T1 only teaches the filter its bias: the unit sits near the ceiling, reads warmer
+// than the room and reports far more often, so letting it vote would drown the room
+// sensor. Once the room sensor goes stale, bias-corrected T1 samples carry the
+// estimate with a larger measurement noise. With neither fresh the estimate is NaN.
+//
+// Every sample is O(1).
+class SensorFusion {
+ public:
+  // 0 disables staleness detection
+  void set_stale_timeout(uint32_t ms) { this->stale_timeout_ = ms; }
+  // Start of the grace period for inputs that have not reported yet (boot)
+  void start(uint32_t now) { this->started_at_ = now; }
+
+  void add_room(float value, uint32_t now);
+  void add_reference(float value, uint32_t now);
+
+  // Fused temperature, NaN when no input is fresh
+  float estimate(uint32_t now) const;
+
+  bool room_fresh(uint32_t now) const { return this->fresh_(this->room_at_, now); }
+  bool reference_fresh(uint32_t now) const { return this->fresh_(this->reference_at_, now); }
+  // Neither input is fresh. Inputs that never reported only count as lost once a
+  // stale timeout has passed since start(), so a slow sensor at boot is not a failure.
+  bool lost(uint32_t now) const;
+  uint32_t room_age(uint32_t now) const { return this->room_at_ == 0 ? UINT32_MAX : now - this->room_at_; }
+  float reference_bias() const { return this->bias_; }
+
+ protected:
+  bool fresh_(uint32_t at, uint32_t now) const;
+  void predict_(uint32_t now);
+  void correct_(float measurement, float noise);
+
+  uint32_t stale_timeout_{30 * 60 * 1000};
+
+  // Median-of-3 window over room samples
+  float window_[3]{};
+  uint8_t window_fill_{0};
+  uint8_t window_pos_{0};
+
+  // Kalman state: temperature estimate and its variance
+  float x_{0.0f};
+  float p_{0.0f};
+  bool initialized_{false};
+  uint32_t predicted_at_{0};
+
+  // T1 minus room, learned while both are fresh
+  float bias_{0.0f};
+  bool bias_known_{false};
+
+  uint32_t room_at_{0};
+  uint32_t reference_at_{0};
+  uint32_t started_at_{0};
+};
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
@@ -1,13 +1,75 @@
 #include "virtual_thermostat.h"
 
+#include <cstring>
+
 namespace esphome {
 namespace virtual_thermostat {
 
 VirtualThermostat::VirtualThermostat(sensor::Sensor *inside_sensor, sensor::Sensor *outside_sensor, climate::Climate *real_climate) 
   : inside_sensor_(inside_sensor), outside_sensor_(outside_sensor), real_climate_(real_climate) {
+  // inside_sensor_ is always zone 0
+  this->zones_.add_zone(1.0f, false);
+}
+
+void VirtualThermostat::add_zone(sensor::Sensor *sensor, float weight) {
+  const uint8_t zone = this->zones_.add_zone(weight, false);
+  // CALLBACK LIFETIME SAFETY: same as the sensor subscriptions in setup()
+  sensor->add_on_state_callback([this, zone](float temperature) { this->on_zone_update(zone, temperature); });
+}
+
+#ifdef USE_BINARY_SENSOR
+void VirtualThermostat::add_zone(sensor::Sensor *sensor, float weight, binary_sensor::BinarySensor *occupancy) {
+  const uint8_t zone = this->zones_.add_zone(weight, true);
+  sensor->add_on_state_callback([this, zone](float temperature) { this->on_zone_update(zone, temperature); });
+  occupancy->add_on_state_callback([this, zone](bool occupied) {
+    this->zones_.set_occupied(zone, occupied);
+    this->on_zone_update(zone, NAN);
+  });
+}
+#endif
+
+void VirtualThermostat::add_real_climate(climate::Climate *real_climate) {
+  this->extra_real_climates_.push_back(real_climate);
+  // A unit changed from elsewhere is pulled back into line on the next sync tick
+  real_climate->add_on_state_callback([this](climate::Climate &climate) {
+    if (!this->updating_from_control_) this->sync_pending_ = true;
+  });
+}
+
+float VirtualThermostat::outside_temperature() const {
+  if (this->outside_sensor_ == nullptr || !this->outside_sensor_->has_state()) return NAN;
+  // A silent outside sensor is treated as unavailable rather than trusted forever
+  if (this->outside_stale_timeout_ != 0 && millis() - this->outside_at_ >= this->outside_stale_timeout_) return NAN;
+  return this->outside_sensor_->state;
+}
+
+float VirtualThermostat::outdoor_reset_offset() const {
+  const float outside = this->outside_temperature();
+  switch (this->arbiter_.mode()) {
+    case ArbiterMode::HEAT:
+      return this->heat_reset_.evaluate(outside);
+    case ArbiterMode::COOL:
+      return this->cool_reset_.evaluate(outside);
+    default:
+      return 0.0f;
+  }
+}
+
+bool VirtualThermostat::commit_real_(RealClimateTransaction &txn) {
+  if (txn.get_target_temperature().has_value()) {
+    this->commanded_target_ = *txn.get_target_temperature();
+  }
+  bool changed = false;
+  for (auto *climate : this->extra_real_climates_) {
+    changed |= txn.commit_to(climate);
+  }
+  changed |= txn.commit();
+  return changed;
 }
 
 void VirtualThermostat::setup() {
+  this->fusion_.start(millis());
+
   // Subscribe to inside sensor state changes for real-time temperature updates
   // CALLBACK LIFETIME SAFETY: The lambda captures 'this' pointer, which is safe because
   // VirtualThermostat is a Component managed by ESPHome's lifecycle system, and the
@@ -27,6 +89,14 @@ void VirtualThermostat::setup() {
     });
   }
   
+  // Subscribe to the unit's own temperature (T1)
+  // CALLBACK LIFETIME SAFETY: Same as above.
+  if (this->t1_sensor_ != nullptr) {
+    this->t1_sensor_->add_on_state_callback([this](float temperature) {
+      this->on_t1_update(temperature);
+    });
+  }
+  
   // Subscribe to real climate state changes
   // CALLBACK LIFETIME SAFETY: Same as above - both the VirtualThermostat and real_climate
   // are managed by ESPHome's component system with synchronized lifecycles.
@@ -42,18 +112,23 @@ void VirtualThermostat::setup() {
   if (restored.has_value()) {
       this->mode = restored->mode;
       this->fan_mode = restored->fan_mode;
-      this->preset = restored->preset;
+      if (restored->uses_custom_preset) {
+        if (restored->custom_preset < this->custom_presets_.size()) {
+          this->active_preset_ = this->custom_presets_[restored->custom_preset];
+        }
+      } else {
+        this->active_preset_ = &getActivePresetFromId(restored->preset);
+      }
       this->target_temperature = restored->target_temperature;
       this->target_temperature_low = restored->target_temperature_low;
       this->target_temperature_high = restored->target_temperature_high;
   }
   const auto& active_preset = getActivePreset();
-  auto [virtual_changed, real_changed] = apply_preset(active_preset);
+  // The real climate has not reported its state yet; leave it to the first sync tick
+  RealClimateTransaction txn(this->real_climate_);
+  const bool virtual_changed = apply_preset(active_preset, txn);
+  this->sync_pending_ = true;
   
-  // Publish state if anything changed
-  if (real_changed) {
-    this->real_climate_->publish_state();
-  }
   if (virtual_changed) {
     this->publish_state();
   }
@@ -73,41 +148,45 @@ climate::ClimateTraits VirtualThermostat::traits() {
     climate::ClimateFanMode::CLIMATE_FAN_MEDIUM,
     climate::ClimateFanMode::CLIMATE_FAN_HIGH
   });
-  traits.set_supported_presets({home.id, sleep.id, away.id, manual.id});
+  climate::ClimatePresetMask presets{manual.id};
+  for (const auto *p : this->presets_) {
+    if (p != nullptr) presets.insert(p->id);
+  }
+  traits.set_supported_presets(presets);
+  traits.set_supported_custom_presets(this->custom_preset_names_);
   return traits;
 }
 
-std::pair<bool, bool> VirtualThermostat::apply_preset(const Preset& p) {
+bool VirtualThermostat::apply_preset(const Preset& p, RealClimateTransaction &txn) {
   bool virtual_changed = false;
-  bool real_changed = false;
   
   // Update virtual thermostat state
-  if (this->preset != p.id) {
-    this->preset = p.id;
+  if (this->active_preset_ != &p || (p.name == nullptr && this->preset != p.id)) {
+    this->active_preset_ = &p;
+    // The trim learned for the previous band does not carry over
+    this->pi_.reset();
+    if (p.name != nullptr) {
+      this->set_custom_preset_(p.name);
+    } else {
+      this->set_preset_(p.id);
+    }
     virtual_changed = true;
   }
   
   const float temp = p.getTargetTemperatureForRealClimate();
-  if (p.id != manual.id) {
+  if (!p.is_manual()) {
     if (this->target_temperature_low != p.min() || this->target_temperature_high != p.max()) {
       this->target_temperature_low  = p.min();
       this->target_temperature_high = p.max();
       virtual_changed = true;
     }
-    if (this->real_climate_ && this->real_climate_->target_temperature != temp) {
-      this->real_climate_->target_temperature = temp;
-      real_changed = true;
-    }
   } else {
     if (this->target_temperature != temp) {
       this->target_temperature = temp;
       virtual_changed = true;
     }
-    if (this->real_climate_ && this->real_climate_->target_temperature != temp) {
-      this->real_climate_->target_temperature = temp;
-      real_changed = true;
-    }
   }
+  txn.set_target_temperature(temp);
   
   auto new_virtual_mode = p.getModeForVirtualThermostat();
   if (this->mode != new_virtual_mode) {
@@ -115,33 +194,43 @@ std::pair<bool, bool> VirtualThermostat::apply_preset(const Preset& p) {
     virtual_changed = true;
   }
   
-  auto new_real_mode = p.getModeForRealClimate();
-  if (new_real_mode.has_value() && this->real_climate_ && this->real_climate_->mode != *new_real_mode) {
-    this->real_climate_->mode = *new_real_mode;
-    real_changed = true;
-  }
-  
-  auto new_fan_mode = p.getFanModeForRealClimate();
-  if (this->real_climate_ && this->real_climate_->fan_mode != new_fan_mode) {
-    this->real_climate_->fan_mode = new_fan_mode;
-    real_changed = true;
-  }
+  txn.set_fan_mode(p.getFanModeForRealClimate());
   
-  // Return what changed but don't publish - let caller decide when to publish
-  return {virtual_changed, real_changed};
+  // Real climate changes are only recorded - the caller commits them once. The real
+  // mode is left to fill_real_climate_(), right before a commit, so the arbiter only
+  // commits to decisions that are actually sent.
+  return virtual_changed;
+}
+
+void VirtualThermostat::add_preset(climate::ClimatePreset id, number::Number *min, number::Number *max) {
+  if (id == manual.id || id >= PRESET_SLOTS) return;
+  auto *p = new Preset(id, this);  // NOLINT(cppcoreguidelines-owning-memory) lives as long as the thermostat
+  p->min_entity(min);
+  p->max_entity(max);
+  this->presets_[id] = p;
 }
 
-const Preset& VirtualThermostat::getActivePreset() const {
-  return getActivePresetFromId(this->preset.value_or(climate::CLIMATE_PRESET_NONE));
+void VirtualThermostat::add_custom_preset(const char *name, number::Number *min, number::Number *max) {
+  auto *p = new Preset(name, this);  // NOLINT(cppcoreguidelines-owning-memory) lives as long as the thermostat
+  p->min_entity(min);
+  p->max_entity(max);
+  this->custom_presets_.push_back(p);
+  this->custom_preset_names_.push_back(name);
 }
 
 const Preset& VirtualThermostat::getActivePresetFromId(climate::ClimatePreset id) const {
-  if (id == home.id)  return home;
-  if (id == sleep.id) return sleep;
-  if (id == away.id)  return away;
+  if (id < PRESET_SLOTS && this->presets_[id] != nullptr) return *this->presets_[id];
   return manual;  // unknown or empty → manual
 }
 
+const Preset& VirtualThermostat::getActivePresetFromName(const char *name) const {
+  // Only runs when a custom preset is selected, so a linear scan is fine
+  for (const auto *p : this->custom_presets_) {
+    if (strcmp(p->name, name) == 0) return *p;
+  }
+  return manual;
+}
+
 void VirtualThermostat::control(const climate::ClimateCall &call) {
   // Set guard flag to indicate we're updating from control, not from external changes
   if (this->updating_from_real_) {
@@ -152,38 +241,36 @@ void VirtualThermostat::control(const climate::ClimateCall &call) {
   this->updating_from_control_ = true;
   
   bool virtual_needs_publish = false;
-  bool real_needs_publish = false;
+  // Everything this pass wants from the real climate is committed as one call at the end
+  RealClimateTransaction txn(this->real_climate_);
 
   // FAN MODE CHANGE
   if (call.get_fan_mode().has_value()) {
     this->fan_mode = *call.get_fan_mode();
-    this->real_climate_->fan_mode = *call.get_fan_mode();
+    txn.set_fan_mode(*call.get_fan_mode());
     virtual_needs_publish = true;
-    real_needs_publish = true;
   }
 
   // PRESET CHANGE
   if (call.get_preset().has_value()) {
     const auto preset_id = *call.get_preset();
     const auto& active_preset = getActivePresetFromId(preset_id);
-    auto [virtual_changed, real_changed] = apply_preset(active_preset);
-    virtual_needs_publish |= virtual_changed;
-    real_needs_publish |= real_changed;
+    virtual_needs_publish |= apply_preset(active_preset, txn);
+  } else if (call.has_custom_preset()) {
+    const auto& active_preset = getActivePresetFromName(call.get_custom_preset());
+    virtual_needs_publish |= apply_preset(active_preset, txn);
   }
 
   // MANUAL EDITS → EXIT PRESET MODE
-  if (call.get_target_temperature_low().has_value()) {
-    auto [virtual_changed, real_changed] = apply_preset(manual);
-    this->target_temperature_low = *call.get_target_temperature_low();
-    virtual_needs_publish = true;  // Always publish when user changes value
-    real_needs_publish |= real_changed;
-  }
-
-  if (call.get_target_temperature_high().has_value()) {
-    auto [virtual_changed, real_changed] = apply_preset(manual);
-    this->target_temperature_high = *call.get_target_temperature_high();
+  if (call.get_target_temperature_low().has_value() || call.get_target_temperature_high().has_value()) {
+    if (call.get_target_temperature_low().has_value()) {
+      this->target_temperature_low = *call.get_target_temperature_low();
+    }
+    if (call.get_target_temperature_high().has_value()) {
+      this->target_temperature_high = *call.get_target_temperature_high();
+    }
+    apply_preset(manual, txn);
     virtual_needs_publish = true;  // Always publish when user changes value
-    real_needs_publish |= real_changed;
   }
 
   // MODE CHANGE
@@ -195,7 +282,7 @@ void VirtualThermostat::control(const climate::ClimateCall &call) {
     if ((new_mode == climate::CLIMATE_MODE_HEAT ||
          new_mode == climate::CLIMATE_MODE_COOL) &&
         this->mode == climate::CLIMATE_MODE_AUTO) {
-      const float temp = active_preset.getTargetTemperatureForRealClimate();
+      const float temp = active_preset.mid();
       this->target_temperature = temp;
       virtual_needs_publish = true;
     }
@@ -204,37 +291,36 @@ void VirtualThermostat::control(const climate::ClimateCall &call) {
     if (new_mode == climate::CLIMATE_MODE_AUTO &&
         (this->mode == climate::CLIMATE_MODE_HEAT ||
          this->mode == climate::CLIMATE_MODE_COOL) &&
-        active_preset.id != manual.id) {
-      auto [virtual_changed, real_changed] = apply_preset(active_preset);
-      virtual_needs_publish |= virtual_changed;
-      real_needs_publish |= real_changed;
+        !active_preset.is_manual()) {
+      virtual_needs_publish |= apply_preset(active_preset, txn);
     } else {
-      // Update mode and sync to real climate
+      // Update mode and sync to real climate; a preset's real mode is filled in before the commit
       this->mode = new_mode;
-      auto real_mode = active_preset.getModeForRealClimate();
-      if (real_mode.has_value() && this->real_climate_) {
-        this->real_climate_->mode = *real_mode;
-        this->real_climate_->target_temperature = active_preset.getTargetTemperatureForRealClimate();
-        real_needs_publish = true;
-      }
+      txn.set_target_temperature(active_preset.getTargetTemperatureForRealClimate());
       virtual_needs_publish = true;
     }
   }
 
   // TARGET TEMPERATURE CHANGE
   if (call.get_target_temperature().has_value()) {
-    auto [virtual_changed, real_changed] = apply_preset(manual);
+    apply_preset(manual, txn);
     const float temp = *call.get_target_temperature();
     this->target_temperature = temp;
-    this->real_climate_->target_temperature = temp;
+    txn.set_target_temperature(temp);
     virtual_needs_publish = true;  // Always publish when user changes value
-    real_needs_publish = true;
   }
 
-  // Publish state if any changes were made
-  if (real_needs_publish) {
-    this->real_climate_->publish_state();
+  // In failsafe the real climate keeps following the failsafe policy, fan changes still go through
+  if (!getActivePreset().is_manual()) {
+    if (this->failsafe_active_) {
+      this->fill_failsafe_(txn);
+    } else {
+      this->fill_real_climate_(getActivePreset(), txn);
+    }
   }
+
+  // One downstream call per unit and one state publish per control pass
+  this->commit_real_(txn);
   if (virtual_needs_publish) {
     this->publish_state();
   }
@@ -243,42 +329,320 @@ void VirtualThermostat::control(const climate::ClimateCall &call) {
 }
 
 void VirtualThermostat::loop() {
-  // State updates are now handled via callbacks, no periodic polling needed
-  // The loop is kept for future extensions if needed
+#ifdef USE_TIME
+  this->check_schedule_();
+#endif
+
+  // Batched sync tick: sensor callbacks only mark the thermostat dirty, the real
+  // climate is reconciled at most once per update_interval
+  const uint32_t now = millis();
+  if (now - this->last_update_time_ < this->update_interval_ms_) {
+    return;
+  }
+  this->last_update_time_ = now;
+
+  // Feed the recovery model with what the real climate has been doing
+  if (this->real_climate_ != nullptr) {
+    RecoveryPhase phase = RecoveryPhase::IDLE;
+    if (this->real_climate_->action == climate::CLIMATE_ACTION_HEATING) {
+      phase = RecoveryPhase::HEATING;
+    } else if (this->real_climate_->action == climate::CLIMATE_ACTION_COOLING) {
+      phase = RecoveryPhase::COOLING;
+    }
+    this->recovery_.observe(getActivePreset().getCurrentInsideTemperatureForRealClimate(),
+                            this->outside_temperature(), phase, now);
+  }
+  this->check_scheduled_preset_(now);
+
+  this->check_watchdog_(now);
+  if (this->failsafe_active_) {
+    return;
+  }
+
+  this->update_setpoint_trim_(now);
+
+  // A change held back by the arbiter may become allowed without new samples arriving
+  if (!this->sync_pending_ && !this->arbiter_.is_holding()) {
+    return;
+  }
+  this->sync_pending_ = false;
+  this->update_real_climate();
+}
+
+void VirtualThermostat::update_setpoint_trim_(uint32_t now) {
+  const auto &preset = getActivePreset();
+  // Manual hands the setpoint to the user as-is
+  if (preset.is_manual()) {
+    this->pi_.reset();
+    return;
+  }
+  // The unit's offset from the room differs between heating and cooling
+  if (this->arbiter_.mode() != this->trim_mode_) {
+    this->trim_mode_ = this->arbiter_.mode();
+    this->pi_.reset();
+  }
+  const float before = this->pi_.command();
+  const float after = this->pi_.update(preset.getRegulatedTemperature(),
+                                       preset.getCurrentInsideTemperatureForRealClimate(), now);
+  if (after != before) {
+    ESP_LOGD("virtual_thermostat", "Setpoint trim %.2f, commanding %.1f", this->pi_.trim(), after);
+    this->sync_pending_ = true;
+  }
+}
+
+void VirtualThermostat::check_watchdog_(uint32_t now) {
+  // Inside temperature is lost when neither the inside sensors nor T1 are fresh; at boot
+  // the sensors get one stale timeout to report before that counts
+  const bool inside_lost = this->fusion_.lost(now);
+  // Manual leaves the real climate in control, so there is nothing to fail over
+  const bool failsafe = inside_lost && !getActivePreset().is_manual();
+
+  if (failsafe != this->failsafe_active_) {
+    this->failsafe_active_ = failsafe;
+    if (failsafe) {
+      ESP_LOGW("virtual_thermostat", "Inside temperature stale, entering failsafe");
+      this->apply_failsafe_();
+    } else {
+      ESP_LOGI("virtual_thermostat", "Inside temperature available again, leaving failsafe");
+      this->sync_pending_ = true;
+    }
+  } else if (failsafe && this->sync_pending_) {
+    // Re-assert the policy if anything (e.g. a follower changed elsewhere) asked for a sync
+    this->sync_pending_ = false;
+    this->apply_failsafe_();
+  }
+
+  const char *state = "OK";
+  if (failsafe) {
+    switch (this->failsafe_mode_) {
+      case FailsafeMode::T1:
+        state = "Failsafe: unit sensor";
+        break;
+      case FailsafeMode::HOLD:
+        state = "Failsafe: hold";
+        break;
+      case FailsafeMode::OFF:
+        state = "Failsafe: off";
+        break;
+    }
+  } else if (this->fusion_.room_age(now) == UINT32_MAX) {
+    state = "Waiting for inside temperature";
+  } else if (!this->fusion_.room_fresh(now)) {
+    state = "Inside stale: using T1";
+  } else if (this->outside_sensor_ != nullptr && std::isnan(this->outside_temperature())) {
+    state = "Outside stale";
+  }
+  this->publish_failsafe_state_(state);
+}
+
+void VirtualThermostat::apply_failsafe_() {
+  RealClimateTransaction txn(this->real_climate_);
+  this->fill_failsafe_(txn);
+  this->updating_from_control_ = true;
+  this->commit_real_(txn);
+  this->updating_from_control_ = false;
+}
+
+void VirtualThermostat::fill_failsafe_(RealClimateTransaction &txn) {
+  // Quantized like the normal path, so the unit echoes exactly what was sent and
+  // the echo is not mistaken for an external change that ends the failsafe
+  switch (this->failsafe_mode_) {
+    case FailsafeMode::T1:
+      txn.set_mode(climate::CLIMATE_MODE_HEAT_COOL);
+      txn.set_target_temperature(this->pi_.quantize(getActivePreset().mid()));
+      break;
+    case FailsafeMode::HOLD:
+      switch (this->arbiter_.mode()) {
+        case ArbiterMode::HEAT:
+          txn.set_mode(climate::CLIMATE_MODE_HEAT);
+          break;
+        case ArbiterMode::COOL:
+          txn.set_mode(climate::CLIMATE_MODE_COOL);
+          break;
+        default:
+          txn.set_mode(climate::CLIMATE_MODE_HEAT_COOL);
+          break;
+      }
+      txn.set_target_temperature(this->pi_.quantize(this->failsafe_temperature_));
+      break;
+    case FailsafeMode::OFF:
+      txn.set_mode(climate::CLIMATE_MODE_OFF);
+      break;
+  }
 }
 
+void VirtualThermostat::publish_failsafe_state_(const char *state) {
+  // Only ever called with string literals, so pointer identity is enough
+  if (state == this->failsafe_state_) return;
+  this->failsafe_state_ = state;
+#ifdef USE_TEXT_SENSOR
+  if (this->failsafe_state_sensor_ != nullptr) {
+    this->failsafe_state_sensor_->publish_state(state);
+  }
+#endif
+}
+
+void VirtualThermostat::schedule_preset(climate::ClimatePreset preset, uint32_t delay_ms) {
+  this->scheduled_preset_ = preset;
+  this->scheduled_at_ = millis() + delay_ms;
+  ESP_LOGD("virtual_thermostat", "Preset %d scheduled in %u s", static_cast<int>(preset), delay_ms / 1000);
+}
+
+void VirtualThermostat::check_scheduled_preset_(uint32_t now) {
+  if (!this->scheduled_preset_.has_value()) return;
+
+  const auto& target = getActivePresetFromId(*this->scheduled_preset_);
+  const int32_t remaining = static_cast<int32_t>(this->scheduled_at_ - now);
+  if (remaining > 0) {
+    // Manual has no band to recover towards, it always switches on time
+    if (target.is_manual()) return;
+    const uint32_t lead = this->recovery_.lead_time(target.getCurrentInsideTemperatureForRealClimate(), target.min(),
+                                                    target.max(), this->outside_temperature(), this->max_preheat_ms_);
+    if (lead < static_cast<uint32_t>(remaining)) return;
+    ESP_LOGI("virtual_thermostat", "Starting preset %d transition %u min ahead of schedule",
+             static_cast<int>(target.id), static_cast<uint32_t>(remaining) / 60000);
+  }
+
+  this->scheduled_preset_.reset();
+  if (&getActivePreset() != &target) {
+    this->make_call().set_preset(target.id).perform();
+  }
+}
+
+#ifdef USE_TIME
+void VirtualThermostat::check_schedule_() {
+  if (this->time_ == nullptr || this->schedule_.empty()) return;
+
+  const time_t now = this->time_->timestamp_now();
+  // Common case: nothing due yet and the clock did not step backwards
+  if (now < this->schedule_handoff_at_ && now >= this->schedule_checked_at_) return;
+
+  const bool clock_stepped_back = now < this->schedule_checked_at_;
+  this->schedule_checked_at_ = now;
+  if (this->schedule_handoff_at_ == 0 || clock_stepped_back) {
+    // First valid time (or a clock correction): follow the slot we are in and plan from here
+    auto local = this->time_->now();
+    if (!local.is_valid()) return;
+    const bool first = this->schedule_handoff_at_ == 0;
+    this->schedule_handoff_at_ = 0;
+    this->plan_schedule_(local, first);
+    return;
+  }
+
+  // Hand the due event to the preset scheduler, which starts it early if needed
+  const time_t remaining = this->schedule_event_at_ > now ? this->schedule_event_at_ - now : 0;
+  this->schedule_preset(static_cast<climate::ClimatePreset>(this->schedule_event_preset_), remaining * 1000);
+
+  auto local = this->time_->now();
+  if (!local.is_valid()) return;
+  this->plan_schedule_(local, false);
+}
+
+void VirtualThermostat::plan_schedule_(const ESPTime &now, bool apply_current) {
+  constexpr int32_t WEEK = WeeklySchedule::MINUTES_PER_WEEK;
+  const uint16_t now_minute = WeeklySchedule::minute_of_week(now.day_of_week, now.hour, now.minute);
+  const time_t minute_start = now.timestamp - now.second;
+
+  uint16_t event_minute;
+  uint8_t preset;
+  if (apply_current && this->schedule_.last_at_or_before(now_minute, &event_minute, &preset) &&
+      &getActivePreset() != &getActivePresetFromId(static_cast<climate::ClimatePreset>(preset))) {
+    ESP_LOGI("virtual_thermostat", "Schedule: resuming preset %d", preset);
+    this->make_call().set_preset(static_cast<climate::ClimatePreset>(preset)).perform();
+  }
+
+  // Plan the event after the one just handed off, or the next one from now
+  int32_t delta;
+  time_t earliest_handoff = 0;
+  if (this->schedule_handoff_at_ != 0) {
+    const uint16_t previous = this->schedule_event_minute_;
+    if (!this->schedule_.next_after(previous, &event_minute, &preset)) return;
+    // Signed distance to the handed-off event (it may have just passed), then on to the next one
+    int32_t to_previous = (previous - now_minute + WEEK) % WEEK;
+    if (to_previous > WEEK / 2) to_previous -= WEEK;
+    int32_t between = (event_minute - previous + WEEK) % WEEK;
+    if (between == 0) between = WEEK;
+    delta = to_previous + between;
+    // Never hand over an event before the previous one has taken effect
+    earliest_handoff = this->schedule_event_at_;
+  } else {
+    if (!this->schedule_.next_after(now_minute, &event_minute, &preset)) return;
+    delta = (event_minute - now_minute + WEEK) % WEEK;
+    if (delta == 0) delta = WEEK;
+  }
+
+  this->schedule_event_minute_ = event_minute;
+  this->schedule_event_preset_ = preset;
+  this->schedule_event_at_ = minute_start + delta * 60;
+  this->schedule_handoff_at_ = this->schedule_event_at_ - this->max_preheat_ms_ / 1000;
+  if (this->schedule_handoff_at_ < earliest_handoff) {
+    this->schedule_handoff_at_ = earliest_handoff;
+  }
+  ESP_LOGD("virtual_thermostat", "Schedule: next event preset %d in %d min", preset, delta);
+}
+#endif
+
 void VirtualThermostat::update_real_climate() {
-  if (!this->real_climate_) return;
-  
+  if (!this->real_climate_ || this->updating_from_control_) return;
+
   const auto& active_preset = getActivePreset();
-  
-  // Update real climate based on current virtual state
-  auto mode = active_preset.getModeForRealClimate();
+  // In manual mode the real climate device is in control
+  if (active_preset.is_manual()) return;
+
+  // Compute the desired state once; the transaction drops fields that already match
+  RealClimateTransaction txn(this->real_climate_);
+  this->fill_real_climate_(active_preset, txn);
+
+  // Our own call echoes back through on_real_climate_update - don't treat it as external
+  this->updating_from_control_ = true;
+  if (this->commit_real_(txn)) {
+    ESP_LOGD("virtual_thermostat", "Sync tick: updated real climate");
+  }
+  this->updating_from_control_ = false;
+}
+
+void VirtualThermostat::fill_real_climate_(const Preset &preset, RealClimateTransaction &txn) {
+  // The only place the arbiter commits a decision: the transaction is always committed right after
+  auto mode = preset.decideModeForRealClimate();
   if (mode.has_value()) {
-    this->real_climate_->mode = *mode;
-    this->real_climate_->fan_mode = active_preset.getFanModeForRealClimate();
-    this->real_climate_->target_temperature = active_preset.getTargetTemperatureForRealClimate();
-    
-    this->real_climate_->publish_state();
+    txn.set_mode(*mode);
   }
+  txn.set_fan_mode(preset.getFanModeForRealClimate());
+  txn.set_target_temperature(preset.getTargetTemperatureForRealClimate());
 }
 
 void VirtualThermostat::on_inside_sensor_update(float temperature) {
-  // Update current temperature from inside sensor in real-time
+  this->on_zone_update(0, temperature);
+}
+
+void VirtualThermostat::on_zone_update(uint8_t zone, float temperature) {
+  // NaN from a zone marks it unavailable; the aggregate falls back to the other zones
   if (!std::isnan(temperature)) {
+    this->zones_.update(zone, temperature);
+  }
+  // Glitches are filtered out before the sample reaches any decision
+  this->fusion_.add_room(this->zones_.value(), millis());
+  this->publish_inside_estimate_();
+}
+
+void VirtualThermostat::on_t1_update(float temperature) {
+  const uint32_t now = millis();
+  this->fusion_.add_reference(temperature, now);
+  // T1 only moves the estimate while the inside sensors are stale
+  if (!this->fusion_.room_fresh(now)) {
+    this->publish_inside_estimate_();
+  }
+}
+
+void VirtualThermostat::publish_inside_estimate_() {
+  const float estimate = this->fusion_.estimate(millis());
+  if (!std::isnan(estimate)) {
     // Use epsilon for float comparison to avoid precision issues
-    bool changed = (std::abs(this->current_temperature - temperature) > 0.01f);
-    this->current_temperature = temperature;
+    bool changed = std::isnan(this->current_temperature) || (std::abs(this->current_temperature - estimate) > 0.01f);
+    this->current_temperature = estimate;
     
-    // If we're in a preset mode (AUTO), inside temperature changes may affect real climate mode
-    const auto& active_preset = getActivePreset();
-    if (active_preset.id != manual.id && !this->updating_from_control_) {
-      auto new_real_mode = active_preset.getModeForRealClimate();
-      if (new_real_mode.has_value() && this->real_climate_ && this->real_climate_->mode != *new_real_mode) {
-        this->real_climate_->mode = *new_real_mode;
-        this->real_climate_->publish_state();
-      }
-    }
+    // Inside temperature changes may affect the real climate mode; reconcile on the next tick
+    this->sync_pending_ = true;
     
     // Publish virtual state if temperature changed
     if (changed) {
@@ -288,17 +652,11 @@ void VirtualThermostat::on_inside_sensor_update(float temperature) {
 }
 
 void VirtualThermostat::on_outside_sensor_update(float temperature) {
-  // When outside temperature changes, reevaluate real climate mode if in preset mode
+  // When outside temperature changes, reevaluate real climate mode on the next tick
   // This is important when inside temp is in range and we use outside temp to decide mode
   if (!std::isnan(temperature)) {
-    const auto& active_preset = getActivePreset();
-    if (active_preset.id != manual.id && !this->updating_from_control_) {
-      auto new_real_mode = active_preset.getModeForRealClimate();
-      if (new_real_mode.has_value() && this->real_climate_ && this->real_climate_->mode != *new_real_mode) {
-        this->real_climate_->mode = *new_real_mode;
-        this->real_climate_->publish_state();
-      }
-    }
+    this->outside_at_ = millis();
+    this->sync_pending_ = true;
   }
 }
 
@@ -317,16 +675,26 @@ void VirtualThermostat::on_real_climate_update() {
   // External changes are authoritative and may exit preset mode
   
   // Check if target temperature changed externally (not from our control)
-  const float expected_temp = active_preset.getTargetTemperatureForRealClimate();
+  const float expected_temp = !std::isnan(this->commanded_target_) ? this->commanded_target_
+                                                                   : active_preset.getTargetTemperatureForRealClimate();
+  // The unit reports its setpoint at its own resolution (a whole-degree unit truncates
+  // 21.5 to 21), so only a difference of a full reported step is an external change
+  float tolerance = this->real_climate_->get_traits().get_visual_target_temperature_step();
+  if (std::isnan(tolerance) || tolerance < 0.1f) {
+    tolerance = 0.1f;
+  } else {
+    tolerance -= 0.01f;
+  }
   if (!std::isnan(this->real_climate_->target_temperature) && 
-      std::abs(this->real_climate_->target_temperature - expected_temp) > 0.1f) {
+      std::abs(this->real_climate_->target_temperature - expected_temp) >= tolerance) {
     // Real climate target temperature changed externally - exit preset mode
     ESP_LOGD("virtual_thermostat", "Real climate target temperature changed externally (%.1f -> %.1f), exiting preset mode",
              expected_temp, this->real_climate_->target_temperature);
     
     // Switch to manual mode
-    if (this->preset != manual.id) {
-      this->preset = manual.id;
+    if (!active_preset.is_manual()) {
+      this->active_preset_ = &manual;
+      this->set_preset_(manual.id);
       virtual_needs_publish = true;
     }
     
@@ -350,7 +718,7 @@ void VirtualThermostat::on_real_climate_update() {
   
   // Check if mode changed externally
   const auto expected_mode = active_preset.getModeForRealClimate();
-  if (expected_mode.has_value() && this->real_climate_->mode != *expected_mode && active_preset.id != manual.id) {
+  if (expected_mode.has_value() && this->real_climate_->mode != *expected_mode && !active_preset.is_manual()) {
     // Real climate mode changed externally - this could be from the device itself
     // We'll log it but not necessarily exit preset mode, as mode changes in preset are normal
     ESP_LOGD("virtual_thermostat", "Real climate mode changed: %d (expected: %d)", 
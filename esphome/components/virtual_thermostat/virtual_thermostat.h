@@ -1,11 +1,29 @@
 #pragma once
 
+#include <array>
+#include <vector>
+
 #include "esphome.h"
 #include "preset.h"
+#include "mode_arbiter.h"
+#include "outdoor_reset.h"
+#include "pi_controller.h"
+#include "real_climate_transaction.h"
+#include "recovery_model.h"
+#include "sensor_fusion.h"
+#include "weekly_schedule.h"
+#include "zone_aggregator.h"
 
 namespace esphome {
 namespace virtual_thermostat {
 
+// What to do with the real climate when no inside temperature is available any more
+enum class FailsafeMode : uint8_t {
+  T1 = 0,    // HEAT_COOL at the band midpoint: the unit regulates on its own sensor
+  HOLD = 1,  // Keep the current direction at a fixed safe setpoint
+  OFF = 2,   // Switch the real climate off
+};
+
 class VirtualThermostat : public climate::Climate, public Component {
 friend class Preset;
 public:
@@ -14,13 +32,66 @@ public:
   sensor::Sensor *outside_sensor_{nullptr};
   climate::Climate *real_climate_{nullptr};
   
-  // Update interval (configured from YAML via codegen) for periodic sync with real climate
+  // Additional inside sensors (zones) aggregated with inside_sensor_, which is zone 0
+  void set_zone_aggregation(ZoneAggregation aggregation) { this->zones_.set_aggregation(aggregation); }
+  void add_zone(sensor::Sensor *sensor, float weight);
+#ifdef USE_BINARY_SENSOR
+  void add_zone(sensor::Sensor *sensor, float weight, binary_sensor::BinarySensor *occupancy);
+#endif
+  // The unit's own temperature (T1), fused with the inside temperature and used when it goes stale
+  void set_t1_sensor(sensor::Sensor *t1_sensor) { this->t1_sensor_ = t1_sensor; }
+  void set_inside_stale_timeout(uint32_t ms) { this->fusion_.set_stale_timeout(ms); }
+
+  // Closed-loop setpoint trim
+  void set_setpoint_step(float step) { this->pi_.set_step(step); }
+  void set_trim_gains(float kp, float ki) { this->pi_.set_gains(kp, ki); }
+  void set_max_setpoint_trim(float max_trim) { this->pi_.set_max_trim(max_trim); }
+  void set_min_setpoint_interval(uint32_t ms) { this->pi_.set_min_interval(ms); }
+
+  // Staleness watchdog and failsafe
+  void set_outside_stale_timeout(uint32_t ms) { this->outside_stale_timeout_ = ms; }
+  void set_failsafe_mode(FailsafeMode mode) { this->failsafe_mode_ = mode; }
+  void set_failsafe_temperature(float temperature) { this->failsafe_temperature_ = temperature; }
+#ifdef USE_TEXT_SENSOR
+  void set_failsafe_state_sensor(text_sensor::TextSensor *sensor) { this->failsafe_state_sensor_ = sensor; }
+#endif
+  // Outside temperature, NaN when unavailable or stale
+  float outside_temperature() const;
+
+  // Additional real climates driven in lockstep with real_climate_
+  void add_real_climate(climate::Climate *real_climate);
+
+  // Outdoor-reset curves (points added in ascending outside temperature by codegen)
+  void add_heat_reset_point(float outside, float offset) { this->heat_reset_.add_point(outside, offset); }
+  void add_cool_reset_point(float outside, float offset) { this->cool_reset_.add_point(outside, offset); }
+  // Setpoint offset for the current outside temperature and arbitrated mode
+  float outdoor_reset_offset() const;
+
+  // Update interval (configured from YAML via codegen) for the batched sync tick with real climate
   void set_update_interval(uint32_t interval_ms) { this->update_interval_ms_ = interval_ms; }
 
-  // Presets (entities wired from YAML/codegen)
-  Preset home { climate::CLIMATE_PRESET_HOME, this };
-  Preset sleep { climate::CLIMATE_PRESET_SLEEP, this };
-  Preset away { climate::CLIMATE_PRESET_AWAY, this };
+  // HEAT/COOL arbitration tuning (configured from YAML via codegen)
+  void set_mode_hysteresis(float hysteresis) { this->arbiter_.set_hysteresis(hysteresis); }
+  void set_min_mode_dwell(uint32_t ms) { this->arbiter_.set_min_dwell(ms); }
+  void set_max_mode_changes_per_hour(uint8_t changes) { this->arbiter_.set_max_changes_per_hour(changes); }
+
+  // Longest a scheduled preset transition may be started ahead of time (0 = start on time)
+  void set_max_preheat_time(uint32_t ms) { this->max_preheat_ms_ = ms; }
+
+  // Switch to 'preset' in 'delay_ms'. The switch is started early when the learned
+  // recovery rate says the new band would otherwise be reached late.
+  void schedule_preset(climate::ClimatePreset preset, uint32_t delay_ms);
+
+  // On-device weekly schedule (packed table generated by codegen, see WeeklySchedule)
+  void set_schedule(const uint32_t *table, uint8_t count) { this->schedule_.set_table(table, count); }
+#ifdef USE_TIME
+  void set_time(time::RealTimeClock *time) { this->time_ = time; }
+#endif
+
+  // Preset registry (one entry per YAML preset, wired from codegen)
+  void add_preset(climate::ClimatePreset id, number::Number *min, number::Number *max);
+  void add_custom_preset(const char *name, number::Number *min, number::Number *max);
+  // Manual always exists: the real climate keeps control and there is no band
   Preset manual { climate::CLIMATE_PRESET_NONE, this };
 
   VirtualThermostat(sensor::Sensor *inside_sensor, sensor::Sensor *outside_sensor, climate::Climate *real_climate);
@@ -32,20 +103,96 @@ public:
   void loop() override;
 
  private:
-  std::pair<bool, bool> apply_preset(const Preset& p);
-  const Preset& getActivePreset() const;
+  bool apply_preset(const Preset& p, RealClimateTransaction &txn);
+  const Preset& getActivePreset() const { return *this->active_preset_; }
   const Preset& getActivePresetFromId(climate::ClimatePreset id) const;
+  const Preset& getActivePresetFromName(const char *name) const;
+
+  // Built-in presets indexed by ClimatePreset (nullptr = not configured), custom presets in YAML order
+  static constexpr size_t PRESET_SLOTS = climate::CLIMATE_PRESET_ACTIVITY + 1;
+  std::array<Preset *, PRESET_SLOTS> presets_{};
+  std::vector<Preset *> custom_presets_;
+  std::vector<const char *> custom_preset_names_;
+  const Preset *active_preset_{&manual};
   void update_real_climate();
+  // Full desired state of a preset, committing the arbiter decision
+  void fill_real_climate_(const Preset &preset, RealClimateTransaction &txn);
   
   // State change callbacks
   void on_inside_sensor_update(float temperature);
+  void on_zone_update(uint8_t zone, float temperature);
+  void on_t1_update(float temperature);
+  void publish_inside_estimate_();
   void on_outside_sensor_update(float temperature);
   void on_real_climate_update();
   
   // Guard flags to prevent infinite update loops
   bool updating_from_real_{false};
   bool updating_from_control_{false};
+
+  // Set by sensor callbacks, consumed by the sync tick in loop()
+  bool sync_pending_{false};
   
+  // Commits one transaction to every real climate; they all get the same mode so they never fight
+  bool commit_real_(RealClimateTransaction &txn);
+  std::vector<climate::Climate *> extra_real_climates_;
+
+  // Inside temperature as seen by the thermostat: aggregate over all zones,
+  // filtered and fused with T1
+  ZoneAggregator zones_;
+  SensorFusion fusion_;
+  sensor::Sensor *t1_sensor_{nullptr};
+
+  // Setpoint trim, run on every sync tick; restarted on preset and HEAT/COOL changes
+  void update_setpoint_trim_(uint32_t now);
+  PiController pi_;
+  ArbiterMode trim_mode_{ArbiterMode::NONE};
+
+  // Watchdog: cheap timestamp compares on every sync tick
+  void check_watchdog_(uint32_t now);
+  void apply_failsafe_();
+  void fill_failsafe_(RealClimateTransaction &txn);
+  void publish_failsafe_state_(const char *state);
+  uint32_t outside_at_{0};
+  uint32_t outside_stale_timeout_{2 * 60 * 60 * 1000};
+  FailsafeMode failsafe_mode_{FailsafeMode::T1};
+  float failsafe_temperature_{20.0f};
+  bool failsafe_active_{false};
+  const char *failsafe_state_{nullptr};
+#ifdef USE_TEXT_SENSOR
+  text_sensor::TextSensor *failsafe_state_sensor_{nullptr};
+#endif
+
+  OutdoorResetCurve heat_reset_;
+  OutdoorResetCurve cool_reset_;
+
+  // Setpoint last sent to the real climate; anything else it reports was changed externally
+  float commanded_target_{NAN};
+
+  // Decides HEAT vs COOL for the real climate while a preset is active
+  ModeArbiter arbiter_;
+
+  // Predictive pre-heating/pre-cooling for scheduled preset transitions
+  void check_scheduled_preset_(uint32_t now);
+  RecoveryModel recovery_;
+  optional<climate::ClimatePreset> scheduled_preset_;
+  uint32_t scheduled_at_{0};
+  uint32_t max_preheat_ms_{2 * 60 * 60 * 1000};
+
+  WeeklySchedule schedule_;
+#ifdef USE_TIME
+  // Weekly schedule evaluation: each event is handed to schedule_preset() once it
+  // enters the pre-heat horizon, so loop() only compares against schedule_handoff_at_
+  void check_schedule_();
+  void plan_schedule_(const ESPTime &now, bool apply_current);
+  time::RealTimeClock *time_{nullptr};
+  time_t schedule_handoff_at_{0};  // 0 = not planned yet
+  time_t schedule_event_at_{0};
+  time_t schedule_checked_at_{0};
+  uint16_t schedule_event_minute_{0};
+  uint8_t schedule_event_preset_{0};
+#endif
+
   uint32_t update_interval_ms_{30000}; // Default 30 seconds
   uint32_t last_update_time_{0};
 };
@@ -0,0 +1,49 @@
+#include "weekly_schedule.h"
+
+namespace esphome {
+namespace virtual_thermostat {
+
+bool WeeklySchedule::next_after(uint16_t minute_of_week, uint16_t *event_minute, uint8_t *preset) const {
+  uint16_t best = MINUTES_PER_WEEK + 1;
+  for (uint8_t i = 0; i < this->count_; i++) {
+    const uint32_t entry = this->table_[i];
+    for (uint8_t day = 0; day < 7; day++) {
+      if (!(days_of(entry) & (1 << day)))
+        continue;
+      const uint16_t at = day * MINUTES_PER_DAY + minute_of(entry);
+      // Distance forward in time; an event at exactly 'minute_of_week' is a week away
+      uint16_t delta = (at + MINUTES_PER_WEEK - minute_of_week) % MINUTES_PER_WEEK;
+      if (delta == 0)
+        delta = MINUTES_PER_WEEK;
+      if (delta < best) {
+        best = delta;
+        *event_minute = at;
+        *preset = preset_of(entry);
+      }
+    }
+  }
+  return best <= MINUTES_PER_WEEK;
+}
+
+bool WeeklySchedule::last_at_or_before(uint16_t minute_of_week, uint16_t *event_minute, uint8_t *preset) const {
+  uint16_t best = MINUTES_PER_WEEK;
+  for (uint8_t i = 0; i < this->count_; i++) {
+    const uint32_t entry = this->table_[i];
+    for (uint8_t day = 0; day < 7; day++) {
+      if (!(days_of(entry) & (1 << day)))
+        continue;
+      const uint16_t at = day * MINUTES_PER_DAY + minute_of(entry);
+      // Distance backward in time
+      const uint16_t delta = (minute_of_week + MINUTES_PER_WEEK - at) % MINUTES_PER_WEEK;
+      if (delta < best) {
+        best = delta;
+        *event_minute = at;
+        *preset = preset_of(entry);
+      }
+    }
+  }
+  return best < MINUTES_PER_WEEK;
+}
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
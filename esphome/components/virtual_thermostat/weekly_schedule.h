@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace virtual_thermostat {
+
+// Weekly preset schedule held in a packed table of uint32_t entries:
+//   bits  0..6   day mask (bit 0 = Sunday ... bit 6 = Saturday)
+//   bits  7..17  minute of day (0..1439)
+//   bits 18..25  preset
+// The table is generated at compile time and lives in flash; this class only
+// keeps a pointer to it.
+class WeeklySchedule {
+ public:
+  static constexpr uint16_t MINUTES_PER_DAY = 24 * 60;
+  static constexpr uint16_t MINUTES_PER_WEEK = 7 * MINUTES_PER_DAY;
+
+  static constexpr uint32_t pack(uint8_t days, uint16_t minute, uint8_t preset) {
+    return (days & 0x7Fu) | ((minute & 0x7FFu) << 7) | (static_cast<uint32_t>(preset) << 18);
+  }
+  static constexpr uint8_t days_of(uint32_t entry) { return entry & 0x7F; }
+  static constexpr uint16_t minute_of(uint32_t entry) { return (entry >> 7) & 0x7FF; }
+  static constexpr uint8_t preset_of(uint32_t entry) { return (entry >> 18) & 0xFF; }
+
+  // day_of_week: 1 = Sunday ... 7 = Saturday (as in ESPTime)
+  static uint16_t minute_of_week(uint8_t day_of_week, uint8_t hour, uint8_t minute) {
+    return (day_of_week - 1) * MINUTES_PER_DAY + hour * 60 + minute;
+  }
+
+  void set_table(const uint32_t *table, uint8_t count) {
+    this->table_ = table;
+    this->count_ = count;
+  }
+  bool empty() const { return this->count_ == 0; }
+
+  // First event strictly after 'minute_of_week', wrapping around the week.
+  // Returns false when the schedule is empty.
+  bool next_after(uint16_t minute_of_week, uint16_t *event_minute, uint8_t *preset) const;
+
+  // Most recent event at or before 'minute_of_week', wrapping around the week.
+  // Returns false when the schedule is empty.
+  bool last_at_or_before(uint16_t minute_of_week, uint16_t *event_minute, uint8_t *preset) const;
+
+ protected:
+  const uint32_t *table_{nullptr};
+  uint8_t count_{0};
+};
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
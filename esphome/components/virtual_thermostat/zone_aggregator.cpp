@@ -0,0 +1,103 @@
+#include "zone_aggregator.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace virtual_thermostat {
+
+uint8_t ZoneAggregator::add_zone(float weight, bool has_occupancy) {
+  this->zones_.push_back({weight, NAN, !has_occupancy});
+  return this->zones_.size() - 1;
+}
+
+void ZoneAggregator::add_(const Zone &zone, float sign) {
+  if (std::isnan(zone.value))
+    return;
+  this->sum_wv_ += sign * zone.weight * zone.value;
+  this->sum_w_ += sign * zone.weight;
+  if (zone.occupied) {
+    this->occupied_wv_ += sign * zone.weight * zone.value;
+    this->occupied_w_ += sign * zone.weight;
+  }
+}
+
+void ZoneAggregator::rebuild_() {
+  this->sum_wv_ = this->sum_w_ = this->occupied_wv_ = this->occupied_w_ = 0.0f;
+  for (const auto &zone : this->zones_)
+    this->add_(zone, 1.0f);
+  this->updates_ = 0;
+}
+
+void ZoneAggregator::rescan_extremes_() {
+  this->min_zone_ = this->max_zone_ = -1;
+  for (size_t i = 0; i < this->zones_.size(); i++) {
+    const float v = this->zones_[i].value;
+    if (std::isnan(v))
+      continue;
+    if (this->min_zone_ < 0 || v < this->zones_[this->min_zone_].value)
+      this->min_zone_ = i;
+    if (this->max_zone_ < 0 || v > this->zones_[this->max_zone_].value)
+      this->max_zone_ = i;
+  }
+}
+
+void ZoneAggregator::update(uint8_t index, float value) {
+  if (index >= this->zones_.size())
+    return;
+  Zone &zone = this->zones_[index];
+  this->add_(zone, -1.0f);
+  zone.value = value;
+  this->add_(zone, 1.0f);
+
+  if (++this->updates_ >= REBUILD_INTERVAL)
+    this->rebuild_();
+
+  // Extremes: a new record is O(1); only the current extreme moving inwards needs a rescan
+  const bool was_min = this->min_zone_ == index;
+  const bool was_max = this->max_zone_ == index;
+  if (std::isnan(value)) {
+    if (was_min || was_max)
+      this->rescan_extremes_();
+    return;
+  }
+  if (this->min_zone_ < 0 || value < this->zones_[this->min_zone_].value) {
+    this->min_zone_ = index;
+  } else if (was_min) {
+    this->rescan_extremes_();
+    return;
+  }
+  if (this->max_zone_ < 0 || value > this->zones_[this->max_zone_].value) {
+    this->max_zone_ = index;
+  } else if (was_max) {
+    this->rescan_extremes_();
+  }
+}
+
+void ZoneAggregator::set_occupied(uint8_t index, bool occupied) {
+  if (index >= this->zones_.size() || this->zones_[index].occupied == occupied)
+    return;
+  Zone &zone = this->zones_[index];
+  this->add_(zone, -1.0f);
+  zone.occupied = occupied;
+  this->add_(zone, 1.0f);
+}
+
+float ZoneAggregator::value() const {
+  switch (this->aggregation_) {
+    case ZoneAggregation::MIN:
+      return this->min_zone_ < 0 ? NAN : this->zones_[this->min_zone_].value;
+    case ZoneAggregation::MAX:
+      return this->max_zone_ < 0 ? NAN : this->zones_[this->max_zone_].value;
+    case ZoneAggregation::OCCUPIED_MEAN:
+      if (this->occupied_w_ > 1e-6f)
+        return this->occupied_wv_ / this->occupied_w_;
+      // Nobody home: fall back to all rooms
+      // fall through
+    case ZoneAggregation::MEAN:
+    default:
+      return this->sum_w_ > 1e-6f ? this->sum_wv_ / this->sum_w_ : NAN;
+  }
+}
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
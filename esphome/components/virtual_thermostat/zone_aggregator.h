@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace esphome {
+namespace virtual_thermostat {
+
+// How the inside temperatures of several rooms are combined into one
+enum class ZoneAggregation : uint8_t {
+  MEAN = 0,           // Weighted mean of all rooms
+  MIN = 1,            // Coldest room
+  MAX = 2,            // Warmest room
+  OCCUPIED_MEAN = 3,  // Weighted mean of occupied rooms, all rooms when none is occupied
+};
+
+// Combines N room temperatures into the single inside temperature the thermostat regulates on.
+//
+// Weighted sums are kept incrementally: an update removes the zone's old contribution and
+// adds the new one, so the mean costs O(1) per sample. The coldest/warmest zone is tracked
+// by index and only rescanned when that zone itself moves away from the extreme. The sums
+// are rebuilt every REBUILD_INTERVAL updates so float rounding cannot accumulate.
+class ZoneAggregator {
+ public:
+  static constexpr uint16_t REBUILD_INTERVAL = 256;
+
+  void set_aggregation(ZoneAggregation aggregation) { this->aggregation_ = aggregation; }
+
+  // Zones without an occupancy input always count as occupied. Returns the zone index.
+  uint8_t add_zone(float weight, bool has_occupancy);
+  size_t size() const { return this->zones_.size(); }
+
+  // NaN marks the zone's temperature as unavailable
+  void update(uint8_t zone, float value);
+  void set_occupied(uint8_t zone, bool occupied);
+
+  // Aggregated temperature, NaN when no zone has a value
+  float value() const;
+
+ protected:
+  struct Zone {
+    float weight;
+    float value;
+    bool occupied;
+  };
+
+  void add_(const Zone &zone, float sign);
+  void rebuild_();
+  void rescan_extremes_();
+
+  std::vector<Zone> zones_;
+  ZoneAggregation aggregation_{ZoneAggregation::MEAN};
+
+  float sum_wv_{0.0f};
+  float sum_w_{0.0f};
+  float occupied_wv_{0.0f};
+  float occupied_w_{0.0f};
+  int16_t min_zone_{-1};
+  int16_t max_zone_{-1};
+  uint16_t updates_{0};
+};
+
+}  // namespace virtual_thermostat
+}  // namespace esphome
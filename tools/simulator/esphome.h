@@ -0,0 +1,318 @@
+#pragma once
+
+// Host-side stand-in for the parts of the ESPHome API the virtual thermostat uses.
+//
+// The component includes "esphome.h"; putting this directory on the include path
+// ahead of the real framework lets the unmodified VirtualThermostat, Preset and
+// RealClimateTransaction sources build and run on the host. Behaviour follows
+// ESPHome where the thermostat depends on it (state callbacks, make_call() ending
+// in control(), optional<> semantics); everything else is left out.
+//
+// Time is simulated: the harness advances sim::now_ms and millis() returns it.
+
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <set>
+#include <vector>
+
+namespace esphome {
+
+template<typename T> using optional = std::optional<T>;
+
+namespace sim {
+inline uint32_t now_ms = 0;
+// Highest level printed: 0 none, 2 warnings, 5 debug
+inline int log_level = 0;
+
+inline void log(int level, const char *tag, const char *format, ...) __attribute__((format(printf, 3, 4)));
+inline void log(int level, const char *tag, const char *format, ...) {
+  if (level > log_level)
+    return;
+  std::printf("[%7.1f min][%s] ", now_ms / 60000.0, tag);
+  va_list args;
+  va_start(args, format);
+  std::vprintf(format, args);
+  va_end(args);
+  std::printf("\n");
+}
+}  // namespace sim
+
+inline uint32_t millis() { return sim::now_ms; }
+
+#define ESP_LOGE(tag, ...) ::esphome::sim::log(1, tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ::esphome::sim::log(2, tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ::esphome::sim::log(3, tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) ::esphome::sim::log(4, tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ::esphome::sim::log(5, tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) ::esphome::sim::log(6, tag, __VA_ARGS__)
+
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+};
+
+namespace sensor {
+
+class Sensor {
+ public:
+  void publish_state(float state) {
+    this->state = state;
+    this->has_state_ = true;
+    for (auto &callback : this->callbacks_)
+      callback(state);
+  }
+  bool has_state() const { return this->has_state_; }
+  void add_on_state_callback(std::function<void(float)> &&callback) { this->callbacks_.push_back(std::move(callback)); }
+
+  float state{NAN};
+
+ protected:
+  bool has_state_{false};
+  std::vector<std::function<void(float)>> callbacks_;
+};
+
+}  // namespace sensor
+
+namespace number {
+
+class NumberTraits {
+ public:
+  void set_min_value(float value) { this->min_ = value; }
+  void set_max_value(float value) { this->max_ = value; }
+  float get_min_value() const { return this->min_; }
+  float get_max_value() const { return this->max_; }
+
+ protected:
+  float min_{0.0f};
+  float max_{100.0f};
+};
+
+class Number {
+ public:
+  void publish_state(float state) {
+    this->state = state;
+    this->has_state_ = true;
+    for (auto &callback : this->callbacks_)
+      callback(state);
+  }
+  bool has_state() const { return this->has_state_; }
+  void add_on_state_callback(std::function<void(float)> &&callback) { this->callbacks_.push_back(std::move(callback)); }
+
+  float state{NAN};
+  NumberTraits traits;
+
+ protected:
+  bool has_state_{false};
+  std::vector<std::function<void(float)>> callbacks_;
+};
+
+}  // namespace number
+
+namespace climate {
+
+enum ClimateMode : uint8_t {
+  CLIMATE_MODE_OFF = 0,
+  CLIMATE_MODE_HEAT_COOL = 1,
+  CLIMATE_MODE_COOL = 2,
+  CLIMATE_MODE_HEAT = 3,
+  CLIMATE_MODE_FAN_ONLY = 4,
+  CLIMATE_MODE_DRY = 5,
+  CLIMATE_MODE_AUTO = 6,
+};
+
+enum ClimateAction : uint8_t {
+  CLIMATE_ACTION_OFF = 0,
+  CLIMATE_ACTION_COOLING = 2,
+  CLIMATE_ACTION_HEATING = 3,
+  CLIMATE_ACTION_IDLE = 4,
+  CLIMATE_ACTION_DRYING = 5,
+  CLIMATE_ACTION_FAN = 6,
+};
+
+enum ClimateFanMode : uint8_t {
+  CLIMATE_FAN_ON = 0,
+  CLIMATE_FAN_OFF = 1,
+  CLIMATE_FAN_AUTO = 2,
+  CLIMATE_FAN_LOW = 3,
+  CLIMATE_FAN_MEDIUM = 4,
+  CLIMATE_FAN_HIGH = 5,
+};
+
+enum ClimatePreset : uint8_t {
+  CLIMATE_PRESET_NONE = 0,
+  CLIMATE_PRESET_HOME = 1,
+  CLIMATE_PRESET_AWAY = 2,
+  CLIMATE_PRESET_BOOST = 3,
+  CLIMATE_PRESET_COMFORT = 4,
+  CLIMATE_PRESET_ECO = 5,
+  CLIMATE_PRESET_SLEEP = 6,
+  CLIMATE_PRESET_ACTIVITY = 7,
+};
+
+enum ClimateFeature : uint32_t {
+  CLIMATE_SUPPORTS_CURRENT_TEMPERATURE = 1 << 0,
+  CLIMATE_SUPPORTS_TWO_POINT_TARGET_TEMPERATURE = 1 << 1,
+  CLIMATE_SUPPORTS_ACTION = 1 << 5,
+};
+inline ClimateFeature operator|(ClimateFeature a, ClimateFeature b) {
+  return static_cast<ClimateFeature>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+using ClimateModeMask = std::set<ClimateMode>;
+using ClimateFanModeMask = std::set<ClimateFanMode>;
+using ClimatePresetMask = std::set<ClimatePreset>;
+
+class ClimateTraits {
+ public:
+  void add_feature_flags(uint32_t flags) { this->feature_flags_ |= flags; }
+  void set_supported_modes(ClimateModeMask modes) { this->modes_ = std::move(modes); }
+  void set_supported_fan_modes(ClimateFanModeMask modes) { this->fan_modes_ = std::move(modes); }
+  void set_supported_presets(ClimatePresetMask presets) { this->presets_ = std::move(presets); }
+  void set_supported_custom_presets(const std::vector<const char *> &presets) { this->custom_presets_ = presets; }
+  void set_visual_temperature_step(float step) { this->target_step_ = step; }
+  void set_visual_target_temperature_step(float step) { this->target_step_ = step; }
+  float get_visual_target_temperature_step() const { return this->target_step_; }
+
+ protected:
+  uint32_t feature_flags_{0};
+  ClimateModeMask modes_;
+  ClimateFanModeMask fan_modes_;
+  ClimatePresetMask presets_;
+  std::vector<const char *> custom_presets_;
+  float target_step_{0.1f};
+};
+
+class Climate;
+
+// Collects the requested fields; perform() hands them to the device's control()
+class ClimateCall {
+ public:
+  explicit ClimateCall(Climate *parent) : parent_(parent) {}
+
+  ClimateCall &set_mode(ClimateMode mode) {
+    this->mode_ = mode;
+    return *this;
+  }
+  ClimateCall &set_target_temperature(float temperature) {
+    this->target_temperature_ = temperature;
+    return *this;
+  }
+  ClimateCall &set_target_temperature_low(float temperature) {
+    this->target_temperature_low_ = temperature;
+    return *this;
+  }
+  ClimateCall &set_target_temperature_high(float temperature) {
+    this->target_temperature_high_ = temperature;
+    return *this;
+  }
+  ClimateCall &set_fan_mode(ClimateFanMode fan_mode) {
+    this->fan_mode_ = fan_mode;
+    return *this;
+  }
+  ClimateCall &set_preset(ClimatePreset preset) {
+    this->preset_ = preset;
+    return *this;
+  }
+  ClimateCall &set_preset(const char *custom_preset) {
+    this->custom_preset_ = custom_preset;
+    return *this;
+  }
+  void perform();
+
+  const optional<ClimateMode> &get_mode() const { return this->mode_; }
+  const optional<float> &get_target_temperature() const { return this->target_temperature_; }
+  const optional<float> &get_target_temperature_low() const { return this->target_temperature_low_; }
+  const optional<float> &get_target_temperature_high() const { return this->target_temperature_high_; }
+  const optional<ClimateFanMode> &get_fan_mode() const { return this->fan_mode_; }
+  const optional<ClimatePreset> &get_preset() const { return this->preset_; }
+  bool has_custom_preset() const { return this->custom_preset_ != nullptr; }
+  const char *get_custom_preset() const { return this->custom_preset_; }
+
+ protected:
+  Climate *parent_;
+  optional<ClimateMode> mode_;
+  optional<float> target_temperature_;
+  optional<float> target_temperature_low_;
+  optional<float> target_temperature_high_;
+  optional<ClimateFanMode> fan_mode_;
+  optional<ClimatePreset> preset_;
+  const char *custom_preset_{nullptr};
+};
+
+struct ClimateDeviceRestoreState {
+  ClimateMode mode;
+  ClimateFanMode fan_mode;
+  bool uses_custom_preset;
+  union {
+    ClimatePreset preset;
+    uint8_t custom_preset;
+  };
+  float target_temperature;
+  float target_temperature_low;
+  float target_temperature_high;
+};
+
+class Climate {
+  friend class ClimateCall;
+
+ public:
+  virtual ~Climate() = default;
+
+  ClimateMode mode{CLIMATE_MODE_OFF};
+  ClimateAction action{CLIMATE_ACTION_OFF};
+  float current_temperature{NAN};
+  float target_temperature{NAN};
+  float target_temperature_low{NAN};
+  float target_temperature_high{NAN};
+  optional<ClimateFanMode> fan_mode;
+  optional<ClimatePreset> preset;
+
+  ClimateCall make_call() { return ClimateCall(this); }
+  ClimateTraits get_traits() { return this->traits(); }
+  void add_on_state_callback(std::function<void(Climate &)> &&callback) {
+    this->callbacks_.push_back(std::move(callback));
+  }
+  void publish_state() {
+    for (auto &callback : this->callbacks_)
+      callback(*this);
+  }
+  bool has_custom_preset() const { return this->custom_preset_ != nullptr; }
+  const char *get_custom_preset() const { return this->custom_preset_; }
+
+ protected:
+  virtual void control(const ClimateCall &call) = 0;
+  virtual ClimateTraits traits() = 0;
+
+  bool set_preset_(ClimatePreset preset) {
+    const bool changed = this->preset != preset || this->custom_preset_ != nullptr;
+    this->preset = preset;
+    this->custom_preset_ = nullptr;
+    return changed;
+  }
+  bool set_custom_preset_(const char *preset) {
+    const bool changed = this->custom_preset_ == nullptr || std::strcmp(this->custom_preset_, preset) != 0;
+    this->custom_preset_ = preset;
+    this->preset.reset();
+    return changed;
+  }
+  // Nothing is persisted across simulated boots
+  optional<ClimateDeviceRestoreState> restore_state_() { return {}; }
+
+  const char *custom_preset_{nullptr};
+  std::vector<std::function<void(Climate &)>> callbacks_;
+};
+
+inline void ClimateCall::perform() { this->parent_->control(*this); }
+
+}  // namespace climate
+
+}  // namespace esphome
+
+using namespace esphome;
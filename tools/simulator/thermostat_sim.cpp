@@ -0,0 +1,351 @@
+// Time-accelerated closed-loop benchmark for the virtual thermostat.
+//
+// Runs the real VirtualThermostat (presets, mode arbiter, outdoor reset, setpoint
+// trim, sensor fusion, zone aggregation, watchdog) against a simulated inverter
+// heat pump and a lumped-capacitance house for 24 h of simulated time, and scores
+// the result:
+//   - comfort: RMS room error against the regulated target and against the band
+//   - bus load: SETs sent to the unit
+//   - wear: HEAT/COOL mode flips and compressor starts
+//   - energy: electrical kWh drawn by the simulated unit
+//
+// The component sources are built unmodified against tools/simulator/esphome.h,
+// a host-side stand-in for the ESPHome API. The heat pump is exposed to the
+// thermostat as a climate entity that takes whole degrees, as the XYE SET does.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -Wall -Itools/simulator -Iesphome/components/virtual_thermostat tools/simulator/thermostat_sim.cpp esphome/components/virtual_thermostat/*.cpp -o /tmp/thermostat_sim && /tmp/thermostat_sim
+//
+// Usage: thermostat_sim [winter|shoulder|summer] [--no-trim] [--seed N] [--verbose]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include "esphome.h"
+#include "virtual_thermostat.h"
+
+using namespace esphome::virtual_thermostat;
+
+namespace {
+
+constexpr uint32_t SECOND = 1000;
+constexpr uint32_t MINUTE = 60 * SECOND;
+constexpr uint32_t HOUR = 60 * MINUTE;
+constexpr uint32_t SIM_STEP = 10 * SECOND;
+constexpr uint32_t SIM_DURATION = 24 * HOUR;
+// millis() never starts at 0 on the device, and 0 means "never" in the engines
+constexpr uint32_t BOOT_OFFSET = 5 * SECOND;
+
+// Outside temperature: daily cosine with the minimum at 05:00
+struct Weather {
+  float mean;
+  float swing;
+
+  float at(uint32_t t) const {
+    const float hours = t / static_cast<float>(HOUR);
+    return this->mean - this->swing * std::cos(2.0f * static_cast<float>(M_PI) * (hours - 5.0f) / 24.0f);
+  }
+};
+
+// Single thermal mass with a heat loss coefficient and solar/internal gains.
+struct House {
+  float temperature{20.0f};
+  float capacity_j_per_k{1.5e7f};  // ~4 h time constant at 1 kW/K
+  float loss_w_per_k{250.0f};
+
+  float gains_w(uint32_t t) const {
+    const float hours = std::fmod(t / static_cast<float>(HOUR), 24.0f);
+    // Occupants and appliances, plus sun through the windows around midday
+    const float internal = (hours >= 7.0f && hours < 23.0f) ? 300.0f : 150.0f;
+    const float solar = (hours > 8.0f && hours < 17.0f) ? 800.0f * std::sin((hours - 8.0f) / 9.0f * M_PI) : 0.0f;
+    return internal + solar;
+  }
+
+  void step(float outside, float heat_w, uint32_t t, float dt_s) {
+    const float flow = this->loss_w_per_k * (outside - this->temperature) + this->gains_w(t) + heat_w;
+    this->temperature += flow * dt_s / this->capacity_j_per_k;
+  }
+};
+
+enum class UnitMode : uint8_t { OFF, HEAT, COOL, AUTO };
+
+// Inverter heat pump regulating on its own return-air sensor (T1), which sits
+// near the ceiling and reads warmer than the room, more so while heating.
+struct HeatPump {
+  static constexpr float MAX_HEAT_W = 6000.0f;
+  static constexpr float MAX_COOL_W = 5000.0f;
+  static constexpr float MIN_MODULATION = 0.25f;
+  static constexpr uint32_t MIN_OFF = 3 * MINUTE;
+
+  UnitMode mode{UnitMode::OFF};
+  float setpoint{21.0f};  // whole degrees, as accepted over XYE
+  bool running{false};
+  bool heating{true};  // direction of the last run, AUTO picks it from T1
+  uint32_t stopped_at{0};
+  float output_w{0.0f};  // positive heats the room, negative cools it
+
+  uint32_t starts{0};
+  double energy_wh{0.0};
+
+  float t1(float room) const { return room + (this->heating ? 1.2f : 0.3f); }
+
+  void step(float room, float outside, uint32_t t, float dt_s) {
+    if (this->mode == UnitMode::HEAT || this->mode == UnitMode::COOL) {
+      this->heating = this->mode == UnitMode::HEAT;
+    } else if (this->mode == UnitMode::AUTO && !this->running) {
+      this->heating = this->t1(room) < this->setpoint;
+    }
+    const float error = this->setpoint - this->t1(room);
+    const float demand = this->mode == UnitMode::OFF ? -1.0f : this->heating ? error : -error;
+
+    // On/off with a 0.5 °C differential and an anti-short-cycle timer, modulating in between
+    if (this->running && demand < -0.5f) {
+      this->running = false;
+      this->stopped_at = t;
+    } else if (!this->running && demand > 0.5f && t - this->stopped_at >= MIN_OFF) {
+      this->running = true;
+      this->starts++;
+    }
+
+    float fraction = 0.0f;
+    if (this->running)
+      fraction = std::clamp(0.5f + demand / 2.0f, MIN_MODULATION, 1.0f);
+
+    float cop;
+    if (this->heating) {
+      this->output_w = fraction * MAX_HEAT_W;
+      cop = std::clamp(3.2f + 0.08f * (outside - 7.0f), 1.5f, 5.0f);
+    } else {
+      this->output_w = -fraction * MAX_COOL_W;
+      cop = std::clamp(3.5f - 0.1f * (outside - 27.0f), 1.8f, 5.0f);
+    }
+    // Part load is more efficient on an inverter; standby draw while idle
+    const float electrical = this->running ? std::fabs(this->output_w) / (cop * (1.2f - 0.2f * fraction)) : 8.0f;
+    this->energy_wh += electrical * dt_s / 3600.0;
+  }
+};
+
+// The heat pump as the thermostat sees it: a climate entity that truncates the
+// setpoint to whole degrees like the XYE SET frame, echoes the truncated value,
+// and reports its compressor state as the action. Every control() is one SET.
+class SimulatedUnit : public climate::Climate {
+ public:
+  HeatPump pump;
+  uint32_t sets{0};
+  uint32_t mode_flips{0};
+
+  void step(float room, float outside, uint32_t t, float dt_s) {
+    this->pump.step(room, outside, t, dt_s);
+    this->current_temperature = std::round(this->pump.t1(room));
+    climate::ClimateAction action = climate::CLIMATE_ACTION_OFF;
+    if (this->mode != climate::CLIMATE_MODE_OFF) {
+      action = !this->pump.running ? climate::CLIMATE_ACTION_IDLE
+               : this->pump.heating ? climate::CLIMATE_ACTION_HEATING
+                                    : climate::CLIMATE_ACTION_COOLING;
+    }
+    if (action != this->action) {
+      this->action = action;
+      this->publish_state();
+    }
+  }
+
+ protected:
+  climate::ClimateTraits traits() override {
+    climate::ClimateTraits traits;
+    traits.set_supported_modes({climate::CLIMATE_MODE_OFF, climate::CLIMATE_MODE_HEAT_COOL, climate::CLIMATE_MODE_COOL,
+                                climate::CLIMATE_MODE_HEAT});
+    traits.set_visual_temperature_step(1.0f);
+    return traits;
+  }
+
+  void control(const climate::ClimateCall &call) override {
+    this->sets++;
+    if (call.get_mode().has_value()) {
+      const auto mode = *call.get_mode();
+      if ((this->mode == climate::CLIMATE_MODE_HEAT && mode == climate::CLIMATE_MODE_COOL) ||
+          (this->mode == climate::CLIMATE_MODE_COOL && mode == climate::CLIMATE_MODE_HEAT))
+        this->mode_flips++;
+      this->mode = mode;
+      switch (mode) {
+        case climate::CLIMATE_MODE_HEAT:
+          this->pump.mode = UnitMode::HEAT;
+          break;
+        case climate::CLIMATE_MODE_COOL:
+          this->pump.mode = UnitMode::COOL;
+          break;
+        case climate::CLIMATE_MODE_HEAT_COOL:
+          this->pump.mode = UnitMode::AUTO;
+          break;
+        default:
+          this->pump.mode = UnitMode::OFF;
+          break;
+      }
+    }
+    if (call.get_target_temperature().has_value()) {
+      this->pump.setpoint = std::trunc(*call.get_target_temperature());
+      this->target_temperature = this->pump.setpoint;
+    }
+    if (call.get_fan_mode().has_value())
+      this->fan_mode = *call.get_fan_mode();
+    this->publish_state();
+  }
+};
+
+// HOME by day, SLEEP at night
+climate::ClimatePreset preset_at(uint32_t t) {
+  const float hours = std::fmod(t / static_cast<float>(HOUR), 24.0f);
+  return hours >= 6.5f && hours < 22.5f ? climate::CLIMATE_PRESET_HOME : climate::CLIMATE_PRESET_SLEEP;
+}
+
+struct Band {
+  number::Number low;
+  number::Number high;
+
+  Band(float low, float high) {
+    this->low.traits.set_min_value(10.0f);
+    this->low.traits.set_max_value(30.0f);
+    this->high.traits.set_min_value(10.0f);
+    this->high.traits.set_max_value(30.0f);
+    this->low.publish_state(low);
+    this->high.publish_state(high);
+  }
+};
+
+struct Scenario {
+  const char *name;
+  Weather weather;
+  float start_temperature;
+};
+
+constexpr Scenario SCENARIOS[] = {
+    {"winter", {2.0f, 5.0f}, 20.0f},
+    {"shoulder", {15.0f, 8.0f}, 21.0f},
+    {"summer", {28.0f, 6.0f}, 24.0f},
+};
+
+struct Stats {
+  double target_sq{0.0};
+  double band_sq{0.0};
+  uint32_t samples{0};
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const Scenario *scenario = &SCENARIOS[0];
+  bool trim = true;
+  unsigned seed = 1;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--no-trim") == 0) {
+      trim = false;
+    } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--verbose") == 0) {
+      sim::log_level = 5;
+    } else {
+      bool found = false;
+      for (const auto &s : SCENARIOS) {
+        if (std::strcmp(argv[i], s.name) == 0) {
+          scenario = &s;
+          found = true;
+        }
+      }
+      if (!found) {
+        std::fprintf(stderr, "usage: %s [winter|shoulder|summer] [--no-trim] [--seed N] [--verbose]\n", argv[0]);
+        return 2;
+      }
+    }
+  }
+
+  std::mt19937 rng(seed);
+  std::normal_distribution<float> sensor_noise(0.0f, 0.08f);
+
+  // Plant
+  House house;
+  house.temperature = scenario->start_temperature;
+  SimulatedUnit unit;
+
+  // Sensors as wired in YAML: living room (zone 0), bedroom, outside and the unit's T1
+  sensor::Sensor living;
+  sensor::Sensor bedroom;
+  sensor::Sensor outside_sensor;
+  sensor::Sensor t1;
+
+  // Thermostat, configured like the README defaults
+  Band home(20.5f, 23.0f);
+  Band sleep(18.5f, 21.5f);
+  VirtualThermostat thermostat(&living, &outside_sensor, &unit);
+  thermostat.add_zone(&bedroom, 0.5f);
+  thermostat.set_t1_sensor(&t1);
+  thermostat.set_update_interval(30 * SECOND);
+  thermostat.set_max_setpoint_trim(trim ? 2.0f : 0.0f);
+  thermostat.add_heat_reset_point(-10.0f, 1.0f);
+  thermostat.add_heat_reset_point(10.0f, 0.0f);
+  thermostat.add_cool_reset_point(25.0f, 0.0f);
+  thermostat.add_cool_reset_point(35.0f, 1.0f);
+  thermostat.add_preset(climate::CLIMATE_PRESET_HOME, &home.low, &home.high);
+  thermostat.add_preset(climate::CLIMATE_PRESET_SLEEP, &sleep.low, &sleep.high);
+
+  sim::now_ms = BOOT_OFFSET;
+  thermostat.setup();
+
+  Stats stats;
+  climate::ClimatePreset preset = climate::CLIMATE_PRESET_NONE;
+
+  for (uint32_t elapsed = 0; elapsed < SIM_DURATION; elapsed += SIM_STEP) {
+    const uint32_t now = BOOT_OFFSET + elapsed;
+    const float dt_s = SIM_STEP / 1000.0f;
+    const float outside = scenario->weather.at(elapsed);
+    sim::now_ms = now;
+
+    unit.step(house.temperature, outside, now, dt_s);
+    house.step(outside, unit.pump.output_w, elapsed, dt_s);
+
+    // Sensor reports: room and outside sensors every minute (0.1 °C resolution), T1 every 30 s
+    if (elapsed % MINUTE == 0) {
+      living.publish_state(std::round((house.temperature + sensor_noise(rng)) * 10.0f) / 10.0f);
+      bedroom.publish_state(std::round((house.temperature - 0.6f + sensor_noise(rng)) * 10.0f) / 10.0f);
+      outside_sensor.publish_state(std::round(outside * 10.0f) / 10.0f);
+    }
+    if (elapsed % (30 * SECOND) == 0)
+      t1.publish_state(unit.current_temperature);
+
+    // What the schedule would do
+    if (preset_at(elapsed) != preset) {
+      preset = preset_at(elapsed);
+      thermostat.make_call().set_preset(preset).perform();
+    }
+
+    thermostat.loop();
+
+    // Score once the first hour has settled the start-up transient
+    if (elapsed >= HOUR) {
+      const Band &band = preset == climate::CLIMATE_PRESET_HOME ? home : sleep;
+      const float low = band.low.state;
+      const float high = band.high.state;
+      const float regulated = std::clamp((low + high) / 2.0f + thermostat.outdoor_reset_offset(), low, high);
+      const float error = house.temperature - regulated;
+      const float outside_band = house.temperature < low    ? low - house.temperature
+                                 : house.temperature > high ? house.temperature - high
+                                                            : 0.0f;
+      stats.target_sq += error * error;
+      stats.band_sq += outside_band * outside_band;
+      stats.samples++;
+    }
+  }
+
+  std::printf("scenario            %s%s\n", scenario->name, trim ? "" : " (no trim)");
+  std::printf("simulated           %u h\n", SIM_DURATION / HOUR);
+  std::printf("rms error target    %.3f °C\n", std::sqrt(stats.target_sq / std::max<uint32_t>(stats.samples, 1)));
+  std::printf("rms error band      %.3f °C\n", std::sqrt(stats.band_sq / std::max<uint32_t>(stats.samples, 1)));
+  std::printf("sets sent           %u\n", unit.sets);
+  std::printf("mode flips          %u\n", unit.mode_flips);
+  std::printf("compressor starts   %u\n", unit.pump.starts);
+  std::printf("energy              %.2f kWh\n", unit.pump.energy_wh / 1000.0);
+  return 0;
+}